@@ -1,5 +1,7 @@
 #include "Instance.h"
 
+#include <algorithm>
+
 /************************************************/
 /*				Constructors					*/
 /************************************************/
@@ -13,6 +15,8 @@ Instance::Instance(const Instance &i) : input(i.getInput()){
 	this->setNbNodes(i.getNbNodes());
 	this->setTabEdge(i.getTabEdge());
 	this->setTabDemand(i.getTabDemand());
+	this->distanceTable = i.distanceTable;
+	this->hopTable = i.hopTable;
 }
 
 /************************************************/
@@ -54,6 +58,7 @@ void Instance::setDemandFromId(int id, Demand & demand){
 /* Builds the initial mapping based on the information retrived from the Input. */
 void Instance::createInitialMapping(){
 	readTopology();
+	computeDistanceTables();
 	readDemands();
 	readDemandAssignment();
 	setNbInitialDemands(getNbRoutedDemands());
@@ -92,6 +97,40 @@ void Instance::readTopology(){
 	this->setNbNodes(maxNode+1);
 }
 
+/* Computes the all-pairs shortest distances and minimum numbers of hops with the Floyd-Warshall algorithm. */
+void Instance::computeDistanceTables(){
+	int n = getNbNodes();
+	distanceTable.assign(n*n, DBL_MAX);
+	hopTable.assign(n*n, INT_MAX);
+	for (int u = 0; u < n; u++){
+		distanceTable[u*n + u] = 0.0;
+		hopTable[u*n + u] = 0;
+	}
+	for (int i = 0; i < getNbEdges(); i++){
+		int u = tabEdge[i].getSource();
+		int v = tabEdge[i].getTarget();
+		double length = std::min(distanceTable[u*n + v], tabEdge[i].getLength());
+		distanceTable[u*n + v] = length;
+		distanceTable[v*n + u] = length;
+		hopTable[u*n + v] = std::min(hopTable[u*n + v], 1);
+		hopTable[v*n + u] = std::min(hopTable[v*n + u], 1);
+	}
+	for (int k = 0; k < n; k++){
+		for (int u = 0; u < n; u++){
+			if (hopTable[u*n + k] == INT_MAX){
+				continue;
+			}
+			for (int v = 0; v < n; v++){
+				if (hopTable[k*n + v] == INT_MAX){
+					continue;
+				}
+				distanceTable[u*n + v] = std::min(distanceTable[u*n + v], distanceTable[u*n + k] + distanceTable[k*n + v]);
+				hopTable[u*n + v] = std::min(hopTable[u*n + v], hopTable[u*n + k] + hopTable[k*n + v]);
+			}
+		}
+	}
+}
+
 /* Reads the routed demand information from file. */
 void Instance::readDemands(){
 	std::cout << "Reading " << input.getDemandFile() << " ..." << std::endl;
@@ -5,6 +5,7 @@
 #include <string>
 #include <iostream>
 #include <float.h>
+#include <climits>
 
 #include "PhysicalLink.h"
 #include "Demand.h"
@@ -24,6 +25,8 @@ private:
 	std::vector<PhysicalLink> tabEdge;	/**< A set of PhysicalLink. **/
 	std::vector<Demand> tabDemand;		/**< A set of Demand (already routed or not). **/
 	int nbInitialDemands;				/**< The number of demands routed in the first initial mapping. **/
+	std::vector<double> distanceTable;	/**< distanceTable[u*nbNodes + v] is the length of the shortest path between nodes u and v in the physical network, DBL_MAX if there is none. **/
+	std::vector<int> hopTable;			/**< hopTable[u*nbNodes + v] is the minimum number of links of a path between nodes u and v, INT_MAX if there is none. **/
 
 public:
 
@@ -58,8 +61,14 @@ public:
 	/** Returns the number of nodes in the physical network. **/
 	int getNbNodes() const { return this->nbNodes; }
 
+	/** Returns the length of the shortest path between two nodes in the physical network, a lower bound on any path between them in any slice layer. @note Returns DBL_MAX if there is none. @param u The first node id. @param v The second node id. **/
+	double getShortestDistance(int u, int v) const { return this->distanceTable[u*nbNodes + v]; }
+
+	/** Returns the minimum number of links of a path between two nodes in the physical network. @note Returns INT_MAX if there is none. @param u The first node id. @param v The second node id. **/
+	int getMinNbHops(int u, int v) const { return this->hopTable[u*nbNodes + v]; }
+
 	/** Returns the instance's input. **/
-	Input getInput() const { return this->input; }
+	const Input & getInput() const { return this->input; }
 
 	/** Returns the PhysicalLink with given index. @param index The index of PhysicalLink required in tabEdge. **/
 	PhysicalLink getPhysicalLinkFromId(int index) const { return this->tabEdge[index]; }	
@@ -114,6 +123,9 @@ public:
 	/** Reads the topology information from input's linkFile. Builds the set of links. @warning File should be structured as in Link.csv. **/
 	void readTopology();
 	
+	/** Computes the shortest distances and the minimum numbers of hops between every pair of nodes of the physical network. Links are used in both directions. @note The topology does not change during a run, so this is only called once, after readTopology. **/
+	void computeDistanceTables();
+
 	/** Reads the routed demand information from input's demandFile. Builds the set of demands. @warning File should be structured as in Demand.csv. **/
 	void readDemands();
 
@@ -1,5 +1,8 @@
 #include "RSA.h"
 
+#include <limits>
+#include <algorithm>
+
 /* Constructor. A graph associated to the initial mapping (instance) is built as well as an extended graph for each demand to be routed. */
 RSA::RSA(const Instance &inst) : instance(inst), compactArcId(compactGraph), compactArcLabel(compactGraph), 
                                 compactArcLength(compactGraph), compactNodeId(compactGraph), 
@@ -22,6 +25,10 @@ RSA::RSA(const Instance &inst) : instance(inst), compactArcId(compactGraph), com
         vecNodeLabel.emplace_back(new NodeMap(*vecGraph[d]));
         vecNodeSlice.emplace_back(new NodeMap(*vecGraph[d]));
         vecOnPath.emplace_back(new ArcMap(*vecGraph[d]));
+        vecGraphVersion.push_back(0);
+        vecVirtualSource.push_back(INVALID);
+        vecVirtualTarget.push_back(INVALID);
+        vecLayerTrees.emplace_back();
     
         for (int i = 0; i < instance.getNbEdges(); i++){
             int linkSourceLabel = instance.getPhysicalLinkFromId(i).getSource();
@@ -39,6 +46,9 @@ RSA::RSA(const Instance &inst) : instance(inst), compactArcId(compactGraph), com
 
     /* Calls preprocessing. */
     preprocessing();
+
+    /* The objective is computed on the arcs left by preprocessing. */
+    buildCoeffs();
 }
 
 /* Builds the simple graph associated with the initial mapping. */
@@ -114,6 +124,17 @@ ListDigraph::Node RSA::getNode(int d, int label, int slice){
     return INVALID;
 }
 
+/* Returns the index of the last demand before the d-th one with the same source, target, load and maximum length. */
+int RSA::getSymmetricPredecessor(int d){
+    for (int k = d-1; k >= 0; k--){
+        if ( (toBeRouted[k].getSource() == toBeRouted[d].getSource()) && (toBeRouted[k].getTarget() == toBeRouted[d].getTarget())
+            && (toBeRouted[k].getLoad() == toBeRouted[d].getLoad()) && (toBeRouted[k].getMaxLength() == toBeRouted[d].getMaxLength()) ){
+            return k;
+        }
+    }
+    return -1;
+}
+
 /* Updates the mapping stored in the given instance with the results obtained from RSA solution (i.e., vecOnPath).*/
 void RSA::updateInstance(Instance &i){
     //instance.displaySlices();
@@ -129,37 +150,62 @@ void RSA::updateInstance(Instance &i){
     instance.displaySlices();
 }
 
-/* Returns the first node with a given label from the graph associated with the d-th demand to be routed. If such node does not exist, return INVALID. */
-ListDigraph::Node RSA::getFirstNodeFromLabel(int d, int label){
+/* Adds the virtual terminals of graph #d. The copies are collected first, since nodes cannot be added while they are iterated. */
+void RSA::addVirtualTerminals(int d){
+    removeVirtualTerminals(d);
+    const int sourceLabel = getToBeRouted_k(d).getSource();
+    const int targetLabel = getToBeRouted_k(d).getTarget();
+    std::vector<ListDigraph::Node> sourceCopies;
+    std::vector<ListDigraph::Node> targetCopies;
     for (ListDigraph::NodeIt v(*vecGraph[d]); v != INVALID; ++v){
-        if (getNodeLabel(v, d) == label){
-            return v;
+        if (getNodeLabel(v, d) == sourceLabel){
+            sourceCopies.push_back(v);
+        }
+        else if (getNodeLabel(v, d) == targetLabel){
+            targetCopies.push_back(v);
         }
     }
-    return INVALID;
+    vecVirtualSource[d] = vecGraph[d]->addNode();
+    setNodeId(vecVirtualSource[d], d, vecGraph[d]->id(vecVirtualSource[d]));
+    setNodeLabel(vecVirtualSource[d], d, sourceLabel);
+    setNodeSlice(vecVirtualSource[d], d, -1);
+    vecVirtualTarget[d] = vecGraph[d]->addNode();
+    setNodeId(vecVirtualTarget[d], d, vecGraph[d]->id(vecVirtualTarget[d]));
+    setNodeLabel(vecVirtualTarget[d], d, targetLabel);
+    setNodeSlice(vecVirtualTarget[d], d, -1);
+    for (unsigned int i = 0; i < sourceCopies.size(); i++){
+        addVirtualArc(d, vecVirtualSource[d], sourceCopies[i]);
+    }
+    for (unsigned int i = 0; i < targetCopies.size(); i++){
+        addVirtualArc(d, targetCopies[i], vecVirtualTarget[d]);
+    }
+    std::cout << "> Virtual terminals of graph #" << d << " are linked to " << sourceCopies.size() << " source and " << targetCopies.size() << " target copies." << std::endl;
 }
 
-/* Contract nodes with the same given label from the graph associated with the d-th demand to be routed. */
-void RSA::contractNodesFromLabel(int d, int label){
-    int nb = 0;
-    ListDigraph::NodeIt previousNode(*vecGraph[d]);
-    ListDigraph::Node n = getFirstNodeFromLabel(d, label);
-    ListDigraph::NodeIt v(*vecGraph[d]);
-    ListDigraph::NodeIt currentNode(*vecGraph[d], v);
-    if (n != INVALID){
-        (*vecNodeSlice[d])[n] = -1;
-        while (v != INVALID){
-            currentNode = v;
-            ListDigraph::NodeIt nextNode(*vecGraph[0], ++currentNode);
-            currentNode = v;
-            if ( (getNodeLabel(v, d) == label) && ((*vecGraph[d]).id(n) != (*vecGraph[d]).id(v)) ){
-                (*vecGraph[0]).contract(n, v);
-                nb++;
-            }
-            v = nextNode;
-        }
+/* Removes the virtual terminals of graph #d. Erasing a node erases its arcs. */
+void RSA::removeVirtualTerminals(int d){
+    if (vecVirtualSource[d] != INVALID){
+        vecGraph[d]->erase(vecVirtualSource[d]);
+        vecVirtualSource[d] = INVALID;
     }
-    std::cout << "> Number of nodes with label " << label << " contracted: " << nb << std::endl; 
+    if (vecVirtualTarget[d] != INVALID){
+        vecGraph[d]->erase(vecVirtualTarget[d]);
+        vecVirtualTarget[d] = INVALID;
+    }
+}
+
+/* Adds a virtual arc to graph #d: no label, no slice and no length. */
+void RSA::addVirtualArc(int d, const ListDigraph::Node &u, const ListDigraph::Node &v){
+    ListDigraph::Arc a = vecGraph[d]->addArc(u, v);
+    setArcId(a, d, vecGraph[d]->id(a));
+    setArcLabel(a, d, -1);
+    setArcSlice(a, d, -1);
+    setArcLength(a, d, 0.0);
+    (*vecOnPath[d])[a] = -1;
+    if (ListDigraph::id(a) >= (int)vecCoeff[d].size()){
+        vecCoeff[d].resize(ListDigraph::id(a) + 1);
+    }
+    vecCoeff[d][ListDigraph::id(a)] = 0.0;
 }
 
 /* Delete arcs that are known 'a priori' to be unable to route on graph #d. */
@@ -179,7 +225,7 @@ void RSA::eraseNonRoutableArcs(int d){
         int uLabel = getNodeLabel((*vecGraph[d]).source(a), d);
         int vLabel = getNodeLabel((*vecGraph[d]).target(a), d);
         if ( (instance.hasEnoughSpace(label, slice, getToBeRouted_k(d)) == false) || (uLabel == demandTarget) || (vLabel == demandSource) ){
-            (*vecGraph[d]).erase(a);
+            eraseArc(d, a);
             nb++;
         }
         a = nextArc;
@@ -217,44 +263,82 @@ int RSA::eraseAllArcsFromSlice(int d, int slice){
     ListDigraph::ArcIt currentArc(*vecGraph[d], a);
     while (a != INVALID){
         currentArc = a;
-        ListDigraph::ArcIt nextArc(*vecGraph[0], ++currentArc);
+        ListDigraph::ArcIt nextArc(*vecGraph[d], ++currentArc);
         currentArc = a;
         if (getArcSlice(a, d) == slice){
             //std::cout << "Erase arc ";
             //displayArc(d, a);
-            (*vecGraph[d]).erase(a);
+            eraseArc(d, a);
             nb++;
         }
         a = nextArc;
     }
     return nb;
 }
-/* Performs preprocessing based on the arc lengths and returns true if at least one arc is erased. */
+/* Returns the key identifying an arc of graph #d in any extended graph of the same demand. */
+ArcKey RSA::getArcKey(const ListDigraph::Arc &a, int d){
+    return ArcKey(getArcLabel(a, d), getArcSlice(a, d), getNodeLabel((*vecGraph[d]).source(a), d));
+}
+
+/* Erases every arc from graph #d whose key is in keys and returns the number of arcs removed. */
+int RSA::eraseArcs(int d, const std::set<ArcKey> &keys){
+    int nb = 0;
+    ListDigraph::ArcIt a(*vecGraph[d]);
+    while (a != INVALID){
+        ListDigraph::Arc arc = a;
+        ++a;
+        if (keys.count(getArcKey(arc, d)) > 0){
+            eraseArc(d, arc);
+            nb++;
+        }
+    }
+    return nb;
+}
+
+/* Performs preprocessing based on the arc lengths and returns true if at least one arc is erased. Arcs too long even on the physical network are erased
+   first in constant time; the distances from the source and to the target are then computed once per graph for all slices. */
 bool RSA::lengthPreprocessing(){
     int totalNb = 0;
+    int nbLanes = getNbSliceLanes();
     for (int d = 0; d < getNbDemandsToBeRouted(); d++){
         //displayGraph(d);
         int nb = 0;
-        ListDigraph::ArcIt previousArc(*vecGraph[d]);
+        int sourceLabel = getToBeRouted_k(d).getSource();
+        int targetLabel = getToBeRouted_k(d).getTarget();
+        double maxLength = getToBeRouted_k(d).getMaxLength();
+        ListDigraph::ArcIt it(*vecGraph[d]);
+        while (it != INVALID){
+            ListDigraph::Arc arc = it;
+            ++it;
+            double toTail = instance.getShortestDistance(sourceLabel, getNodeLabel((*vecGraph[d]).source(arc), d));
+            double fromHead = instance.getShortestDistance(getNodeLabel((*vecGraph[d]).target(arc), d), targetLabel);
+            if (toTail == DBL_MAX || fromHead == DBL_MAX || toTail + getArcLength(arc, d) + fromHead >= maxLength + DBL_EPSILON){
+                eraseArc(d, arc);
+                nb++;
+            }
+        }
+        const std::vector<double> &fromSource = getLayerTree(d, sourceLabel, true);
+        const std::vector<double> &toTarget = getLayerTree(d, targetLabel, false);
         ListDigraph::ArcIt a(*vecGraph[d]);
-        ListDigraph::ArcIt currentArc(*vecGraph[d], a);
         while (a != INVALID){
-            currentArc = a;
-            ListDigraph::ArcIt nextArc(*vecGraph[0], ++currentArc);
-            currentArc = a;
-            int slice = getArcSlice(a, d);
-            ListDigraph::Node source = getNode(d, getToBeRouted_k(d).getSource(), slice);
-            ListDigraph::Node target = getNode(d, getToBeRouted_k(d).getTarget(), slice);
-            if (source != INVALID && target != INVALID){
-                if (shortestDistance(d, source, a, target) >= getToBeRouted_k(d).getMaxLength() + DBL_EPSILON){
-                    (*vecGraph[d]).erase(a);
-                    nb++;
-                }
+            ListDigraph::Arc arc = a;
+            ++a;
+            int slice = getArcSlice(arc, d);
+            int tail = getNodeLabel((*vecGraph[d]).source(arc), d);
+            int head = getNodeLabel((*vecGraph[d]).target(arc), d);
+            double distance = fromSource[tail*nbLanes + slice] + getArcLength(arc, d) + toTarget[head*nbLanes + slice];
+            if (distance >= maxLength + DBL_EPSILON){
+                eraseArc(d, arc);
+                nb++;
             }
-            else{
-                nb += eraseAllArcsFromSlice(d, slice);
+        }
+        /* An erased arc is on no path within the length limit: the distances at the endpoints of the remaining arcs, and from the source to the
+           target, are unchanged. Both trees stay valid. */
+        for (unsigned int k = 0; k < vecLayerTrees[d].size(); k++){
+            LayerTree &tree = vecLayerTrees[d][k];
+            if ((tree.root == sourceLabel && tree.fromRoot) || (tree.root == targetLabel && !tree.fromRoot)){
+                tree.version = vecGraphVersion[d];
             }
-            a = nextArc;
         }
         std::cout << "> Number of erased arcs due to length in graph #" << d << ": " << nb << std::endl;
         totalNb += nb;
@@ -265,6 +349,104 @@ bool RSA::lengthPreprocessing(){
     return false;
 }
 
+/* Returns the number of slice lanes used by computeLayerDistances. */
+int RSA::getNbSliceLanes() const {
+    int nbLanes = 0;
+    for (int i = 0; i < instance.getNbEdges(); i++){
+        nbLanes = std::max(nbLanes, instance.getPhysicalLinkFromId(i).getNbSlices());
+    }
+    return nbLanes;
+}
+
+/* Computes the shortest path lengths between a root and every node for all the slice layers of graph #d at once. */
+void RSA::computeLayerDistances(int d, int root, bool fromRoot, std::vector<double> &dist){
+    const double INF = std::numeric_limits<double>::infinity();
+    int nbLanes = getNbSliceLanes();
+    int nbLinks = instance.getNbEdges();
+    int nbNodes = instance.getNbNodes();
+
+    // the links incident to each node, as (link, other endpoint)
+    std::vector<int> linkSource(nbLinks);
+    std::vector<double> linkLength(nbLinks);
+    std::vector< std::vector< std::pair<int, int> > > incident(nbNodes);
+    for (int i = 0; i < nbLinks; i++){
+        PhysicalLink edge = instance.getPhysicalLinkFromId(i);
+        linkSource[i] = edge.getSource();
+        linkLength[i] = edge.getLength();
+        incident[edge.getSource()].push_back(std::make_pair(i, edge.getTarget()));
+        incident[edge.getTarget()].push_back(std::make_pair(i, edge.getSource()));
+    }
+
+    // blocked[(2*link + dir)*nbLanes + slice] is 0 if graph #d has the arc, +Infinity otherwise. dir is 0 for the arcs going from the link source to the link target.
+    std::vector<double> blocked(2*nbLinks*nbLanes, INF);
+    for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+        if (isVirtualArc(a, d)){
+            continue;
+        }
+        int label = getArcLabel(a, d);
+        int dir = (getNodeLabel((*vecGraph[d]).source(a), d) == linkSource[label]) ? 0 : 1;
+        blocked[(2*label + dir)*nbLanes + getArcSlice(a, d)] = 0.0;
+    }
+
+    dist.assign(nbNodes*nbLanes, INF);
+    std::fill(dist.begin() + root*nbLanes, dist.begin() + (root+1)*nbLanes, 0.0);
+    std::deque<int> queue(1, root);
+    std::vector<bool> inQueue(nbNodes, false);
+    inQueue[root] = true;
+    while (!queue.empty()){
+        int u = queue.front();
+        queue.pop_front();
+        inQueue[u] = false;
+        for (unsigned int j = 0; j < incident[u].size(); j++){
+            int link = incident[u][j].first;
+            int v = incident[u][j].second;
+            // the arc goes from u to v when computing distances from the root, from v to u otherwise
+            int dir = ((linkSource[link] == u) == fromRoot) ? 0 : 1;
+            const double *block = &blocked[(2*link + dir)*nbLanes];
+            const double *distU = &dist[u*nbLanes];
+            double *distV = &dist[v*nbLanes];
+            double length = linkLength[link];
+            int improved = 0;
+            for (int s = 0; s < nbLanes; s++){
+                double candidate = distU[s] + length + block[s];
+                improved |= (candidate < distV[s]);
+                distV[s] = std::min(distV[s], candidate);
+            }
+            if (improved && !inQueue[v]){
+                queue.push_back(v);
+                inQueue[v] = true;
+            }
+        }
+    }
+}
+
+/* Returns the slice-layer distances between a root and every node of graph #d, computing them only if no tree is memoized for the current version. */
+const std::vector<double> & RSA::getLayerTree(int d, int root, bool fromRoot){
+    std::deque<LayerTree> &trees = vecLayerTrees[d];
+    for (unsigned int k = 0; k < trees.size(); k++){
+        if (trees[k].root == root && trees[k].fromRoot == fromRoot){
+            if (trees[k].version != vecGraphVersion[d]){
+                computeLayerDistances(d, root, fromRoot, trees[k].dist);
+                trees[k].version = vecGraphVersion[d];
+            }
+            return trees[k].dist;
+        }
+    }
+    trees.push_back(LayerTree());
+    LayerTree &tree = trees.back();
+    tree.root = root;
+    tree.fromRoot = fromRoot;
+    tree.version = vecGraphVersion[d];
+    computeLayerDistances(d, root, fromRoot, tree.dist);
+    return tree.dist;
+}
+
+/* Erases an arc from graph #d and increments the version of the graph. */
+void RSA::eraseArc(int d, const ListDigraph::Arc &a){
+    (*vecGraph[d]).erase(a);
+    vecGraphVersion[d]++;
+}
+
 /* Returns the distance of the shortest path from source to target passing through arc a. */
 double RSA::shortestDistance(int d, ListDigraph::Node &s, ListDigraph::Arc &a, ListDigraph::Node &t){
     double distance = 0.0;
@@ -292,112 +474,62 @@ double RSA::shortestDistance(int d, ListDigraph::Node &s, ListDigraph::Arc &a, L
     return distance;
 }
 
-/* Returns the coefficient of an arc according to metric 1 on graph #d. */
-double RSA::getCoeffObj1(const ListDigraph::Arc &a, int d){
-    double coeff = 0.0;
-    ListDigraph::Node u = (*vecGraph[d]).source(a);
-    int uLabel = getNodeLabel(u, d);
-    int arcSlice = getArcSlice(a, d);
-    if(uLabel == getToBeRouted_k(d).getSource()){
-        coeff = arcSlice + 1; 
-    }
-    else{
-        coeff = 1; 
-    }
-    return coeff;
-}
-
-/* Returns the coefficient of an arc according to metric 1p on graph #d. */
-double RSA::getCoeffObj1p(const ListDigraph::Arc &a, int d){
-    double coeff = 0.0;
-    int arcLabel = getArcLabel(a, d);
-    int arcSlice = getArcSlice(a, d);
-    int maxSliceUsedOnLink = instance.getPhysicalLinkFromId(arcLabel).getMaxUsedSlicePosition();
-    if(arcSlice <= maxSliceUsedOnLink){
-        coeff = maxSliceUsedOnLink; 
-    }
-    else{
-        coeff = arcSlice; 
+/* Fills the coefficient array of graph #d, indexed by arc id, with a metric policy. */
+template <class Metric>
+void RSA::fillCoeffs(int d, const MetricData &data){
+    std::vector<double> &coeff = vecCoeff[d];
+    coeff.assign((*vecGraph[d]).maxArcId() + 1, 0.0);
+    for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+        int tailLabel = getNodeLabel((*vecGraph[d]).source(a), d);
+        coeff[ListDigraph::id(a)] = Metric::getCoeff(tailLabel, getArcLabel(a, d), getArcSlice(a, d), getArcLength(a, d), data);
     }
-    return coeff;
 }
 
-/* Returns the coefficient of an arc according to metric 2 on graph #d. */
-double RSA::getCoeffObj2(const ListDigraph::Arc &a, int d){
-    double coeff = 1.0;
-    return coeff;
-}
-
-/* Returns the coefficient of an arc according to metric 4 on graph #d. */
-double RSA::getCoeffObj4(const ListDigraph::Arc &a, int d){
-    return getArcLength(a, d);
-}
-
-/* Returns the coefficient of an arc according to metric 8 on graph #d. */
-double RSA::getCoeffObj8(const ListDigraph::Arc &a, int d){
-    double coeff = 0.0;
-    int maxSliceUsed = 0;
+/* Computes the coefficient of every arc of every graph. The used slices are read once for all graphs, and the metric is chosen once per graph. */
+void RSA::buildCoeffs(){
+    MetricData data;
+    data.maxUsedSlice = 0;
     for (int i = 0; i < instance.getNbEdges(); i++){
-        int maxSliceUsedOnLink = instance.getPhysicalLinkFromId(i).getMaxUsedSlicePosition();
-        if (maxSliceUsedOnLink >= maxSliceUsed){
-            maxSliceUsed = maxSliceUsedOnLink;
-        }
-    }
-    int arcSlice = getArcSlice(a, d);
-    ListDigraph::Node u = (*vecGraph[d]).source(a);
-    int uLabel = getNodeLabel(u, d);
-    if(uLabel == getToBeRouted_k(d).getSource()){
-        if(arcSlice <= maxSliceUsed){
-            coeff = maxSliceUsed + 1; 
-        }
-        else{
-            coeff = arcSlice + 1; 
-        }
+        data.maxUsedSliceOnLink.push_back(instance.getPhysicalLinkFromId(i).getMaxUsedSlicePosition());
+        data.maxUsedSlice = std::max(data.maxUsedSlice, data.maxUsedSliceOnLink.back());
     }
-    else{
-        coeff = 1;
-    }
-    return coeff;
-}
-
-/* Returns the coefficient of an arc (according to the chosen metric) on graph #d. */
-double RSA::getCoeff(const ListDigraph::Arc &a, int d){
-    double coeff = 0.0;
-    switch (getInstance().getInput().getChosenObj()){
-        case Input::OBJECTIVE_METRIC_1:
-        {
-            coeff = getCoeffObj1(a, d);
-            break;
-        }
-        case Input::OBJECTIVE_METRIC_1p:
-        {
-            coeff = getCoeffObj1p(a, d);
-            break;
-        }
-        case Input::OBJECTIVE_METRIC_2:
-        {
-            coeff = getCoeffObj2(a, d);
-            break;
-        }
-        case Input::OBJECTIVE_METRIC_4:
-        {
-            coeff = getCoeffObj4(a, d);
-            break;
-        }
-        case Input::OBJECTIVE_METRIC_8:
-        {
-            coeff = getCoeffObj8(a, d);
-            break;
-        }
-        default:
-        {
-            std::cerr << "Objective metric out of range.\n";
-            exit(0);
-            break;
+    vecCoeff.resize(getNbDemandsToBeRouted());
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        data.sourceLabel = getToBeRouted_k(d).getSource();
+        switch (instance.getInput().getChosenObj()){
+            case Input::OBJECTIVE_METRIC_1:
+            {
+                fillCoeffs<MetricObj1>(d, data);
+                break;
+            }
+            case Input::OBJECTIVE_METRIC_1p:
+            {
+                fillCoeffs<MetricObj1p>(d, data);
+                break;
+            }
+            case Input::OBJECTIVE_METRIC_2:
+            {
+                fillCoeffs<MetricObj2>(d, data);
+                break;
+            }
+            case Input::OBJECTIVE_METRIC_4:
+            {
+                fillCoeffs<MetricObj4>(d, data);
+                break;
+            }
+            case Input::OBJECTIVE_METRIC_8:
+            {
+                fillCoeffs<MetricObj8>(d, data);
+                break;
+            }
+            default:
+            {
+                std::cerr << "Objective metric out of range.\n";
+                exit(0);
+                break;
+            }
         }
     }
-    
-    return coeff;
 }
 
 /* Displays the demands to be routed in the next optimization. */
@@ -2,8 +2,13 @@
 #define __RSA__h
 
 #include "Instance.h"
+#include "objectiveMetric.h"
 
-#include<ilcplex/ilocplex.h>
+#include <sstream>
+#include <memory>
+#include <set>
+#include <deque>
+#include <tuple>
 #include <lemon/list_graph.h>
 #include <lemon/concepts/graph.h>
 #include <lemon/dijkstra.h>
@@ -15,6 +20,20 @@ using namespace lemon;
 typedef ListDigraph::NodeMap<int> NodeMap;
 typedef ListDigraph::ArcMap<int> ArcMap;
 typedef ListDigraph::ArcMap<double> ArcCost;
+typedef std::tuple<int, int, int> ArcKey;    /* (link label, slice, tail label): identifies an arc of an extended graph independently of its id */
+
+/* Read-only arc map over a vector indexed by arc ids, so that Dijkstra reads a flat cost array directly. */
+class FlatArcCost {
+public:
+    typedef ListDigraph::Arc Key;
+    typedef double Value;
+
+    FlatArcCost(const std::vector<double> &c) : cost(c) {}
+    Value operator[](const Key &a) const { return cost[ListDigraph::id(a)]; }
+
+private:
+    const std::vector<double> &cost;
+};
 
 /**********************************************************************************************
  * This class stores the input needed for solving the Routing and Spectrum Allocation problem.
@@ -65,6 +84,34 @@ protected:
         \note (*vecOnPath[i])[a] is the id the demand routed through arc a in the graph associated with the i-th demand to be routed. **/
     std::vector< std::shared_ptr<ArcMap> > vecOnPath;
 
+    /** The slice-layer distances between a root and every node of an extended graph, computed by computeLayerDistances at a given version of the graph. **/
+    struct LayerTree {
+        int root;                   /**< The root's label. **/
+        bool fromRoot;              /**< True for the distances from the root, false for the distances to the root. **/
+        int version;                /**< The version of the graph at which the distances are exact. **/
+        std::vector<double> dist;   /**< The distances, indexed by label*getNbSliceLanes() + slice. **/
+    };
+
+    /** The version of each extended graph, incremented whenever arcs are erased from it. 
+        \note vecGraphVersion[i] is the version of the graph associated with the i-th demand to be routed. **/
+    std::vector<int> vecGraphVersion;
+
+    /** The layer trees memoized for each extended graph during the lifetime of the object, shared by preprocessing, feasibility tests and heuristics. A deque keeps the references returned by getLayerTree valid. 
+        \note vecLayerTrees[i] stores the trees of the graph associated with the i-th demand to be routed. **/
+    std::vector< std::deque<LayerTree> > vecLayerTrees;
+
+    /** The virtual source of each extended graph, linked to every copy of the demand's source, or INVALID if it has not been added. 
+        \note vecVirtualSource[i] is the virtual source of the graph associated with the i-th demand to be routed. **/
+    std::vector<ListDigraph::Node> vecVirtualSource;
+
+    /** The virtual target of each extended graph, linked from every copy of the demand's target, or INVALID if it has not been added. 
+        \note vecVirtualTarget[i] is the virtual target of the graph associated with the i-th demand to be routed. **/
+    std::vector<ListDigraph::Node> vecVirtualTarget;
+
+    /** The objective coefficient of each arc of each extended graph, computed once by buildCoeffs with the policy of the chosen metric. Virtual arcs have a null coefficient. 
+        \note vecCoeff[i][id] is the coefficient of the arc with the given id in the graph associated with the i-th demand to be routed. **/
+    std::vector< std::vector<double> > vecCoeff;
+
 
     ListDigraph compactGraph;   /**< The simple graph associated with the initial mapping. **/
     ArcMap compactArcId;        /**< ArcMap storing the arc ids of the simple graph associated with the initial mapping. **/
@@ -86,7 +133,7 @@ public:
 	/****************************************************************************************/
     
     /** Returns the input instance. **/
-    Instance getInstance() const{ return instance; }
+    const Instance & getInstance() const{ return instance; }
 
     /** Returns the vector of demands to be routed. **/
     std::vector<Demand> getToBeRouted() { return toBeRouted; } 
@@ -118,29 +165,26 @@ public:
     /** Returns the length of an arc in a graph. @param a The arc. @param d The graph #d. **/
     double getArcLength(const ListDigraph::Arc &a, int d) const  {return (*vecArcLength[d])[a]; }
 
+    /** Returns true if an arc links a virtual terminal to a copy of the demand's source or target. Such arcs have label and slice -1 and length 0. @param a The arc. @param d The graph #d. **/
+    bool isVirtualArc(const ListDigraph::Arc &a, int d) const { return getArcLabel(a, d) == -1; }
+
+    /** Returns the virtual source of a graph, or INVALID if it has not been added. @param d The graph #d. **/
+    ListDigraph::Node getVirtualSource(int d) const { return vecVirtualSource[d]; }
+
+    /** Returns the virtual target of a graph, or INVALID if it has not been added. @param d The graph #d. **/
+    ListDigraph::Node getVirtualTarget(int d) const { return vecVirtualTarget[d]; }
+
+    /** Returns the index of the last demand before the d-th one with the same source, target, load and maximum length, or -1 if there is none. Such demands are interchangeable in any solution. @param d The demand index. **/
+    int getSymmetricPredecessor(int d);
+
     /** Returns the first node identified by (label, slice) on graph #d. @param d The graph #d. @param label The node's label. @param slice The node's slice. \warning If it does not exist, returns INVALID. **/
     ListDigraph::Node getNode(int d, int label, int slice);
 
     /** Returns the length of an arc on the compact graph. @param a The arc. */
     double getCompactLength(const ListDigraph::Arc &a) { return compactArcLength[a]; }
     
-    /** Returns the coefficient of an arc (according to the chosen metric) on graph #d. @param a The arc. @param d The graph #d. @todo Implement other metrics. For the moment, only 1p is used. **/
-    double getCoeff(const ListDigraph::Arc &a, int d);
-    
-    /** Returns the coefficient of an arc according to metric 1 on graph #d. @param a The arc. @param d The graph #d. **/
-    double getCoeffObj1(const ListDigraph::Arc &a, int d);
-
-    /** Returns the coefficient of an arc according to metric 1p on graph #d. @param a The arc. @param d The graph #d. @warning Only adapted for the case of treating one demand at a time. **/
-    double getCoeffObj1p(const ListDigraph::Arc &a, int d);
-
-    /** Returns the coefficient of an arc according to metric 2 on graph #d. @param a The arc. @param d The graph #d. @todo I do not really understand this metric -> to be implemented. **/
-    double getCoeffObj2(const ListDigraph::Arc &a, int d);
-
-    /** Returns the coefficient of an arc according to metric 4 on graph #d. @param a The arc. @param d The graph #d. **/
-    double getCoeffObj4(const ListDigraph::Arc &a, int d);
-
-    /** Returns the coefficient of an arc according to metric 8 on graph #d. @param a The arc. @param d The graph #d. @warning Only adapted for the case of treating one demand at a time. **/
-    double getCoeffObj8(const ListDigraph::Arc &a, int d);
+    /** Returns the coefficient of an arc (according to the chosen metric) on graph #d. @param a The arc. @param d The graph #d. **/
+    double getCoeff(const ListDigraph::Arc &a, int d) const { return vecCoeff[d][ListDigraph::id(a)]; }
 
 	/****************************************************************************************/
 	/*										Setters											*/
@@ -183,11 +227,20 @@ public:
     /** Updates the mapping stored in the given instance with the results obtained from RSA solution (i.e., vecOnPath). @param i The instance to be updated.*/
     void updateInstance(Instance &i);
 
-    /** Returns the first node with a given label from the graph associated with the d-th demand to be routed. @note If such node does not exist, returns INVALID. @param d The graph #d. @param label The node's label. **/
-    ListDigraph::Node getFirstNodeFromLabel(int d, int label);
-    
-    /** Contract nodes with the same given label from the graph associated with the d-th demand to be routed. @param d The graph #d. @param label The node's label. **/
-    void contractNodesFromLabel(int d, int label);
+    /** Adds to graph #d a virtual source, with an arc to every copy of the demand's source, and a virtual target, with an arc from every copy of the demand's target. A single search from the virtual source then covers every slice layer, without merging the copies. Virtual terminals have the label of the terminal they stand for and slice -1. @param d The graph #d. **/
+    void addVirtualTerminals(int d);
+
+    /** Removes the virtual terminals of graph #d and their arcs, if any, leaving the graph as it was before addVirtualTerminals. @param d The graph #d. **/
+    void removeVirtualTerminals(int d);
+
+    /** Adds a virtual arc to graph #d. @param d The graph #d. @param u The tail. @param v The head. **/
+    void addVirtualArc(int d, const ListDigraph::Node &u, const ListDigraph::Node &v);
+
+    /** Computes the coefficient of every arc of every graph, choosing the policy of the chosen metric once. **/
+    void buildCoeffs();
+
+    /** Fills the coefficient array of graph #d with a metric policy. @param d The graph #d. @param data The data of the current mapping needed by the metric. **/
+    template <class Metric> void fillCoeffs(int d, const MetricData &data);
 
     /** Delete arcs that are known 'a priori' to be unable to route on graph #d. Erase arcs that do not support the demand's load. @param d The graph #d to be inspected. **/
     void eraseNonRoutableArcs(int d);
@@ -195,12 +248,30 @@ public:
     /** Erases every arc from graph #d having the given slice and returns the number of arcs removed. @param d The graph #d. @param slice The slice to be removed. **/
     int eraseAllArcsFromSlice(int d, int slice);
 
+    /** Returns the key identifying an arc of graph #d in any extended graph of the same demand. @param a The arc. @param d The graph #d. **/
+    ArcKey getArcKey(const ListDigraph::Arc &a, int d);
+
+    /** Erases every arc from graph #d whose key is in keys and returns the number of arcs removed. @param d The graph #d. @param keys The keys of the arcs to be removed. **/
+    int eraseArcs(int d, const std::set<ArcKey> &keys);
+
     /** Runs preprocessing on every extended graph. **/
     void preprocessing();
     
     /** Performs preprocessing based on the arc lengths and returns true if at least one arc is erased. An arc (u,v) can only be part of a solution if the distance from demand source to u, plus the distance from v to demand target plus the arc length is less than or equal to the demand's maximum length. **/
     bool lengthPreprocessing();
 
+    /** Returns the number of slice lanes used by computeLayerDistances, i.e., the largest number of slices of a link. **/
+    int getNbSliceLanes() const;
+
+    /** Computes at once, for every slice layer of graph #d, the length of the shortest path between the node with a given label and every other node. The sweep is a label-correcting algorithm on the compact graph where each distance holds one lane per slice, an arc being blocked in the lanes where it is absent from graph #d. @param d The graph #d. @param root The root's label. @param fromRoot True for the distances from the root, false for the distances to the root. @param dist Receives the distances indexed by label*getNbSliceLanes() + slice, +Infinity if there is no path. **/
+    void computeLayerDistances(int d, int root, bool fromRoot, std::vector<double> &dist);
+
+    /** Returns the slice-layer distances between a root and every node of graph #d, computing them only if no tree is memoized for the current version of the graph. @param d The graph #d. @param root The root's label. @param fromRoot True for the distances from the root, false for the distances to the root. **/
+    const std::vector<double> & getLayerTree(int d, int root, bool fromRoot);
+
+    /** Erases an arc from graph #d and increments the version of the graph. @param d The graph #d. @param a The arc to be erased. **/
+    void eraseArc(int d, const ListDigraph::Arc &a);
+
     /** Returns the distance of the shortest path from source to target passing through arc a. \note If there exists no st-path, returns +Infinity. @param d The graph #d. @param source The source node.  @param a The arc required to be present. @param target The target node.  **/
     double shortestDistance(int d, ListDigraph::Node &source, ListDigraph::Arc &a, ListDigraph::Node &target);
 
@@ -0,0 +1,84 @@
+#include "bucketQueue.h"
+
+#include <cmath>
+#include <algorithm>
+
+/* Inserts a value in the binary heap. */
+void BinaryHeapQueue::push(double key, int value){
+    heap.push(Entry(key, (long long)values.size()));
+    values.push_back(value);
+}
+
+/* Removes and returns the value with the smallest key from the binary heap. */
+int BinaryHeapQueue::pop(){
+    int value = values[heap.top().second];
+    heap.pop();
+    if (heap.empty()){
+        values.clear();
+    }
+    return value;
+}
+
+/* Inserts a value in its bucket. */
+void DialQueue::push(double key, int value){
+    buckets[std::llround(key) % (long long)buckets.size()].push_back(value);
+    size++;
+}
+
+/* Removes and returns the first value of the first non-empty bucket from the current key. */
+int DialQueue::pop(){
+    int b = (int)(current % (long long)buckets.size());
+    while (first[b] == buckets[b].size()){
+        buckets[b].clear();
+        first[b] = 0;
+        current++;
+        b = (int)(current % (long long)buckets.size());
+    }
+    int value = buckets[b][first[b]];
+    first[b]++;
+    size--;
+    return value;
+}
+
+/* Returns the bucket of an internal key: 0 if it equals last, otherwise one plus the highest bit in which they differ. */
+int RadixHeap::getBucket(unsigned long long key) const {
+    unsigned long long diff = key ^ last;
+    int bucket = 0;
+    while (diff != 0){
+        diff >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/* Inserts a value in the radix heap. The internal key holds the key in its high bits and the insertion rank in its low 32 bits. */
+void RadixHeap::push(double key, int value){
+    unsigned long long internalKey = ((unsigned long long)std::llround(key) << 32) | (nbPushed & 0xFFFFFFFFULL);
+    nbPushed++;
+    buckets[getBucket(internalKey)].push_back(Entry(internalKey, value));
+    size++;
+}
+
+/* Removes and returns the value with the smallest key. If bucket 0 is empty, the first non-empty bucket is redistributed around its minimum. */
+int RadixHeap::pop(){
+    if (buckets[0].empty()){
+        int b = 1;
+        while (buckets[b].empty()){
+            b++;
+        }
+        unsigned long long minKey = buckets[b][0].first;
+        for (unsigned int i = 1; i < buckets[b].size(); i++){
+            minKey = std::min(minKey, buckets[b][i].first);
+        }
+        last = minKey;
+        std::vector<Entry> moved;
+        moved.swap(buckets[b]);
+        for (unsigned int i = 0; i < moved.size(); i++){
+            buckets[getBucket(moved[i].first)].push_back(moved[i]);
+        }
+    }
+    int value = buckets[0].back().second;
+    buckets[0].pop_back();
+    size--;
+    return value;
+}
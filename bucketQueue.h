@@ -0,0 +1,99 @@
+#ifndef __bucketQueue__h
+#define __bucketQueue__h
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+
+/*********************************************************************************************
+* The priority queues below store values (e.g., label indices) by non-negative keys and share
+* the same interface: push(key, value), pop() returning the value with the smallest key, and
+* empty(). Values with equal keys are popped in insertion order. The bucket queues are monotone:
+* a key pushed must not be smaller than the key of the last value popped.
+*********************************************************************************************/
+
+/*********************************************************************************************
+* A binary heap, used when keys are not integral.
+*********************************************************************************************/
+class BinaryHeapQueue {
+
+private:
+    typedef std::pair<double, long long> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > heap;    /**< Entries ordered by key, then by insertion order. **/
+    std::vector<int> values;                                                        /**< values[i] is the value of the i-th entry pushed. **/
+
+public:
+    /** Constructor. Creates an empty queue. **/
+    BinaryHeapQueue() {}
+
+    /** Returns true if the queue is empty. **/
+    bool empty() const { return heap.empty(); }
+
+    /** Inserts a value. @param key The value's key. @param value The value. **/
+    void push(double key, int value);
+
+    /** Removes and returns the value with the smallest key. **/
+    int pop();
+};
+
+/*********************************************************************************************
+* Dial's bucket queue for small non-negative integer keys. When the difference between the keys
+* stored at once is at most maxDelta (e.g., the largest arc cost of a shortest path search),
+* maxDelta + 1 circular buckets suffice and each operation costs O(1) amortized.
+*********************************************************************************************/
+class DialQueue {
+
+private:
+    std::vector< std::vector<int> > buckets;    /**< buckets[key % nbBuckets] stores the values of a key, in insertion order. **/
+    std::vector<unsigned int> first;            /**< first[b] is the position of the next value to be popped from bucket b. **/
+    long long current;                          /**< The key of the last value popped. **/
+    int size;                                   /**< The number of values stored. **/
+
+public:
+    /** Constructor. Creates an empty queue. @param maxDelta The largest difference between two keys stored at once. **/
+    DialQueue(int maxDelta) : buckets(maxDelta + 1), first(maxDelta + 1, 0), current(0), size(0) {}
+
+    /** Returns true if the queue is empty. **/
+    bool empty() const { return size == 0; }
+
+    /** Inserts a value. @param key The value's key, rounded to the nearest integer. @param value The value. **/
+    void push(double key, int value);
+
+    /** Removes and returns the value with the smallest key. **/
+    int pop();
+};
+
+/*********************************************************************************************
+* A radix heap for non-negative integer keys of any range (e.g., fixed-point lengths). Entries
+* are kept in buckets by the highest bit in which their key differs from the last key popped,
+* so each entry is moved at most 64 times. Ties are broken by insertion order through the low
+* 32 bits of the internal key.
+*********************************************************************************************/
+class RadixHeap {
+
+private:
+    typedef std::pair<unsigned long long, int> Entry;
+    std::vector< std::vector<Entry> > buckets;  /**< buckets[b] stores the entries whose internal key first differs from last at bit b-1 (bucket 0: equal). **/
+    unsigned long long last;                    /**< The internal key of the last entry popped. **/
+    unsigned long long nbPushed;                /**< The number of entries pushed, used for breaking ties. **/
+    int size;                                   /**< The number of entries stored. **/
+
+    /** Returns the bucket of an internal key. @param key The internal key. **/
+    int getBucket(unsigned long long key) const;
+
+public:
+    /** Constructor. Creates an empty queue. **/
+    RadixHeap() : buckets(65), last(0), nbPushed(0), size(0) {}
+
+    /** Returns true if the queue is empty. **/
+    bool empty() const { return size == 0; }
+
+    /** Inserts a value. @param key The value's key, rounded to the nearest integer. @param value The value. **/
+    void push(double key, int value);
+
+    /** Removes and returns the value with the smallest key. **/
+    int pop();
+};
+
+#endif
@@ -0,0 +1,364 @@
+#include "columnGeneration.h"
+
+#include <algorithm>
+
+/* Constructor. Builds the master problem, generates columns and solves the integer master. */
+ColumnGeneration::ColumnGeneration(const Instance &inst) : RSA(inst), model(env), cplex(model), nbSlices(0), iteration(0),
+                    MAX_NB_IT(inst.getInput().getMaxNbPricingIterations()), artificialCost(0.0), lpValue(-__DBL_MAX__),
+                    lowerBound(-__DBL_MAX__), isFeasible(false){
+    std::cout << "--- Column generation has been chosen ---" << std::endl;
+    for (int i = 0; i < instance.getNbEdges(); i++){
+        nbSlices = std::max(nbSlices, instance.getPhysicalLinkFromId(i).getNbSlices());
+    }
+    cplex.setOut(env.getNullStream());
+    initMaster();
+    initPricing();
+    std::cout << "> Master problem was initialized. " << std::endl;
+
+    IloNum timeStart = cplex.getCplexTime();
+    bool STOP = false;
+    while (!STOP){
+        cplex.solve();
+        lpValue = cplex.getObjValue();
+        updateReducedCosts();
+        int nbNewColumns = 0;
+        double lagrangianBound = lpValue;
+        for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+            double minReducedCost = 0.0;
+            nbNewColumns += price(d, minReducedCost);
+            lagrangianBound += std::min(minReducedCost, 0.0);
+        }
+        lowerBound = std::max(lowerBound, lagrangianBound);
+        iteration++;
+        std::cout << "> Round " << iteration << ". LP: " << lpValue << ". Lower bound: " << lowerBound << ". New columns: " << nbNewColumns << ". Total: " << getNbColumns() << std::endl;
+        if (nbNewColumns == 0 || iteration >= MAX_NB_IT){
+            STOP = true;
+        }
+    }
+    IloNum timeFinish = cplex.getCplexTime();
+    if (iteration < MAX_NB_IT){
+        std::cout << "> Column generation converged in " << timeFinish - timeStart << " secs. LP: " << lpValue << ". Lower bound: " << lowerBound << std::endl;
+    }
+    else{
+        std::cout << "> Column generation stopped after " << iteration << " rounds without converging. Lower bound: " << lowerBound << std::endl;
+    }
+    solveIntegerMaster();
+}
+
+/* Creates the master problem with one artificial column per demand. */
+void ColumnGeneration::initMaster(){
+    objective = IloMinimize(env);
+    model.add(objective);
+    convexity = IloRangeArray(env);
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        std::string constraintName = "Convexity(" + std::to_string(getToBeRouted_k(d).getId() + 1) + ")";
+        convexity.add(IloRange(env, 1, 1, constraintName.c_str()));
+    }
+    model.add(convexity);
+    nonOverlap = IloRangeArray(env);
+    for (int label = 0; label < instance.getNbEdges(); label++){
+        for (int s = 0; s < nbSlices; s++){
+            std::string constraintName = "Overlap(" + std::to_string(label + 1) + "," + std::to_string(s + 1) + ")";
+            nonOverlap.add(IloRange(env, -IloInfinity, 1, constraintName.c_str()));
+        }
+    }
+    model.add(nonOverlap);
+    lambda = IloNumVarArray(env);
+    artificial = IloNumVarArray(env);
+    artificialCost = computeArtificialCost();
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        std::string varName = "a(" + std::to_string(getToBeRouted_k(d).getId() + 1) + ")";
+        artificial.add(IloNumVar(objective(artificialCost) + convexity[d](1), 0.0, IloInfinity, ILOFLOAT, varName.c_str()));
+    }
+}
+
+/* Returns a cost larger than the cost of any solution routing every demand. A path uses at most one arc per node of its slice layer. */
+double ColumnGeneration::computeArtificialCost(){
+    const int maxNbArcs = std::max(1, instance.getNbNodes() - 1);
+    double cost = 1.0;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        double maxCoeff = 0.0;
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            maxCoeff = std::max(maxCoeff, getCoeff(a, d));
+        }
+        cost += maxNbArcs*maxCoeff;
+    }
+    return cost;
+}
+
+/* Stores the flat arc lengths and slices and the source/target node of each slice layer of every graph. */
+void ColumnGeneration::initPricing(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const int nbArcs = (*vecGraph[d]).maxArcId() + 1;
+        vecFlatLength.emplace_back(nbArcs, 0.0);
+        vecReducedCost.emplace_back(nbArcs, 0.0);
+        vecFlatSlice.emplace_back(nbArcs, 0);
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            vecFlatLength[d][ListDigraph::id(a)] = getArcLength(a, d);
+            vecFlatSlice[d][ListDigraph::id(a)] = getArcSlice(a, d);
+        }
+        vecLayerSource.push_back(std::vector<ListDigraph::Node>(nbSlices, INVALID));
+        vecLayerTarget.push_back(std::vector<ListDigraph::Node>(nbSlices, INVALID));
+        for (ListDigraph::NodeIt v(*vecGraph[d]); v != INVALID; ++v){
+            int slice = getNodeSlice(v, d);
+            if (getNodeLabel(v, d) == getToBeRouted_k(d).getSource()){
+                vecLayerSource[d][slice] = v;
+            }
+            if (getNodeLabel(v, d) == getToBeRouted_k(d).getTarget()){
+                vecLayerTarget[d][slice] = v;
+            }
+        }
+    }
+}
+
+/* Adds a column to the master problem. */
+void ColumnGeneration::addColumn(const PathColumn &column){
+    const Demand demand = getToBeRouted_k(column.demand);
+    IloNumColumn col = objective(column.cost) + convexity[column.demand](1);
+    for (unsigned int i = 0; i < column.arcs.size(); i++){
+        int label = getArcLabel(column.arcs[i], column.demand);
+        for (int s = column.slice - demand.getLoad() + 1; s <= column.slice; s++){
+            col += nonOverlap[label*nbSlices + s](1);
+        }
+    }
+    std::string varName = "l(" + std::to_string(demand.getId() + 1) + "," + std::to_string(getNbColumns() + 1) + ")";
+    lambda.add(IloNumVar(col, 0.0, IloInfinity, ILOFLOAT, varName.c_str()));
+    col.end();
+    columns.push_back(column);
+}
+
+/* Updates the reduced cost of every arc according to the duals of the last solved master. */
+void ColumnGeneration::updateReducedCosts(){
+    IloNumArray overlapDuals(env);
+    cplex.getDuals(overlapDuals, nonOverlap);
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const int load = getToBeRouted_k(d).getLoad();
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            int label = getArcLabel(a, d);
+            int slice = getArcSlice(a, d);
+            double reducedCost = getCoeff(a, d);
+            for (int s = slice - load + 1; s <= slice; s++){
+                reducedCost -= std::min((double)overlapDuals[label*nbSlices + s], 0.0);
+            }
+            vecReducedCost[d][ListDigraph::id(a)] = reducedCost;
+        }
+    }
+    overlapDuals.end();
+}
+
+/* Searches for columns with negative reduced cost for the d-th demand and adds them to the master. */
+int ColumnGeneration::price(int d, double &minReducedCost){
+    const double convexityDual = cplex.getDual(convexity[d]);
+    std::vector<PathColumn> column;
+    std::vector<bool> found;
+    std::vector<double> layerBound;
+    priceLayers(d, column, found, layerBound);
+    std::vector<PathColumn> candidates;
+    double minLayerBound = __DBL_MAX__;
+    for (int s = getToBeRouted_k(d).getLoad() - 1; s < nbSlices; s++){
+        minLayerBound = std::min(minLayerBound, layerBound[s]);
+        if (found[s]){
+            if (getPathReducedCost(column[s]) - convexityDual < -EPSILON){
+                candidates.push_back(column[s]);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](const PathColumn &c1, const PathColumn &c2){
+        return getPathReducedCost(c1) < getPathReducedCost(c2);
+    });
+    int nb = std::min((int)candidates.size(), MAX_NB_COLUMNS_PER_DEMAND);
+    for (int i = 0; i < nb; i++){
+        addColumn(candidates[i]);
+    }
+    /* No layer holds a feasible path: only the artificial column is left, whose reduced cost is non-negative. */
+    if (minLayerBound == __DBL_MAX__){
+        minReducedCost = 0.0;
+    }
+    else{
+        minReducedCost = minLayerBound - convexityDual;
+    }
+    return nb;
+}
+
+/* Searches, on every slice layer of graph #d at once, for a path of small reduced cost respecting the demand's maximal length. For any u >= 0, a path of layer s within the length limit costs at least the Dijkstra value of s at u minus u*maxLength: bound[s] keeps the best such value. */
+void ColumnGeneration::priceLayers(int d, std::vector<PathColumn> &column, std::vector<bool> &found, std::vector<double> &bound){
+    const double MAX_LENGTH = getToBeRouted_k(d).getMaxLength();
+    column.assign(nbSlices, PathColumn());
+    found.assign(nbSlices, false);
+    bound.assign(nbSlices, __DBL_MAX__);
+    std::vector<double> u(nbSlices, 0.0);
+    std::vector<PathColumn> infeasible;
+    std::vector<bool> reached;
+    shortestPaths(d, 1.0, u, infeasible, reached);
+    std::vector<bool> isActive(nbSlices, false);
+    bool hasActive = false;
+    for (int s = 0; s < nbSlices; s++){
+        if (reached[s] == false){
+            continue;
+        }
+        if (infeasible[s].length <= MAX_LENGTH + EPSILON){
+            bound[s] = getPathReducedCost(infeasible[s]);
+            column[s] = infeasible[s];
+            found[s] = true;
+        }
+        else{
+            isActive[s] = true;
+            hasActive = true;
+        }
+    }
+    if (hasActive == false){
+        return;
+    }
+    /* On the other layers, the path minimizing the reduced cost is too long: look for the shortest one. */
+    std::vector<PathColumn> candidate;
+    shortestPaths(d, 0.0, std::vector<double>(nbSlices, 1.0), candidate, reached);
+    for (int s = 0; s < nbSlices; s++){
+        if (isActive[s]){
+            if (candidate[s].length > MAX_LENGTH + EPSILON){
+                isActive[s] = false;
+                continue;
+            }
+            column[s] = candidate[s];
+            found[s] = true;
+            bound[s] = getPathReducedCost(infeasible[s]);
+        }
+    }
+    /* Move the multiplier u[s] of each layer along the breakpoints of the lower hull of (reduced cost, length). */
+    for (int k = 0; k < MAX_NB_BREAKPOINTS; k++){
+        hasActive = false;
+        for (int s = 0; s < nbSlices; s++){
+            if (isActive[s]){
+                double denominator = infeasible[s].length - column[s].length;
+                if (denominator <= EPSILON){
+                    isActive[s] = false;
+                    continue;
+                }
+                u[s] = (getPathReducedCost(column[s]) - getPathReducedCost(infeasible[s]))/denominator;
+                hasActive = true;
+            }
+        }
+        if (hasActive == false){
+            break;
+        }
+        shortestPaths(d, 1.0, u, candidate, reached);
+        for (int s = 0; s < nbSlices; s++){
+            if (isActive[s]){
+                double candidateValue = getPathReducedCost(candidate[s]) + u[s]*candidate[s].length;
+                bound[s] = std::max(bound[s], candidateValue - u[s]*MAX_LENGTH);
+                if (candidateValue >= getPathReducedCost(column[s]) + u[s]*column[s].length - EPSILON){
+                    isActive[s] = false;
+                }
+                else if (candidate[s].length <= MAX_LENGTH + EPSILON){
+                    column[s] = candidate[s];
+                }
+                else{
+                    infeasible[s] = candidate[s];
+                }
+            }
+        }
+    }
+    for (int s = 0; s < nbSlices; s++){
+        if (found[s]){
+            bound[s] = std::min(bound[s], getPathReducedCost(column[s]));
+        }
+    }
+}
+
+/* Runs one Dijkstra on graph #d from the sources of every slice layer, with arc costs costWeight*reducedCost + u[s]*length on layer s, and stores the path found to the target of each layer. */
+void ColumnGeneration::shortestPaths(int d, double costWeight, const std::vector<double> &u, std::vector<PathColumn> &path, std::vector<bool> &reached){
+    path.assign(nbSlices, PathColumn());
+    reached.assign(nbSlices, false);
+    LayerArcCost costMap(vecReducedCost[d], vecFlatLength[d], vecFlatSlice[d], costWeight, u);
+    Dijkstra< ListDigraph, LayerArcCost > dijkstra((*vecGraph[d]), costMap);
+    dijkstra.init();
+    for (int s = getToBeRouted_k(d).getLoad() - 1; s < nbSlices; s++){
+        if (vecLayerSource[d][s] != INVALID && vecLayerTarget[d][s] != INVALID){
+            dijkstra.addSource(vecLayerSource[d][s]);
+        }
+    }
+    dijkstra.start();
+    for (int s = getToBeRouted_k(d).getLoad() - 1; s < nbSlices; s++){
+        if (vecLayerSource[d][s] != INVALID && vecLayerTarget[d][s] != INVALID && dijkstra.reached(vecLayerTarget[d][s])){
+            reached[s] = true;
+            storePath(dijkstra, d, s, path[s]);
+        }
+    }
+}
+
+/* Stores the path found by a Dijkstra run from the source to the target of slice layer s of graph #d. */
+void ColumnGeneration::storePath(Dijkstra< ListDigraph, LayerArcCost > &path, int d, int s, PathColumn &column){
+    column.demand = d;
+    column.slice = s;
+    column.cost = 0.0;
+    column.length = 0.0;
+    column.arcs.clear();
+    ListDigraph::Node n = vecLayerTarget[d][s];
+    while (n != vecLayerSource[d][s]){
+        ListDigraph::Arc arc = path.predArc(n);
+        n = path.predNode(n);
+        column.arcs.push_back(arc);
+        column.cost += getCoeff(arc, d);
+        column.length += vecFlatLength[d][ListDigraph::id(arc)];
+    }
+    std::reverse(column.arcs.begin(), column.arcs.end());
+}
+
+/* Returns the reduced cost of a path, without the dual of the convexity constraint. */
+double ColumnGeneration::getPathReducedCost(const PathColumn &column){
+    double reducedCost = 0.0;
+    for (unsigned int i = 0; i < column.arcs.size(); i++){
+        reducedCost += vecReducedCost[column.demand][ListDigraph::id(column.arcs[i])];
+    }
+    return reducedCost;
+}
+
+/* Solves the master problem with integer variables and stores the selected paths on vecOnPath. */
+void ColumnGeneration::solveIntegerMaster(){
+    model.add(IloConversion(env, lambda, ILOINT));
+    model.add(IloConversion(env, artificial, ILOINT));
+    cplex.setOut(std::cout);
+    cplex.setParam(IloCplex::Param::MIP::Display, 2);
+    std::cout << "Solving integer master with " << getNbColumns() << " columns..." << std::endl;
+    cplex.solve();
+    if (cplex.getStatus() != IloAlgorithm::Optimal){
+        std::cout << "Could not find a path!" << std::endl;
+        return;
+    }
+    isFeasible = true;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        if (cplex.getValue(artificial[d]) >= 0.9){
+            isFeasible = false;
+        }
+    }
+    if (isFeasible == false){
+        std::cout << "Could not find a path!" << std::endl;
+        return;
+    }
+    std::cout << "Objective Function Value: " << cplex.getObjValue() << std::endl;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            (*vecOnPath[d])[a] = -1;
+        }
+    }
+    for (int j = 0; j < getNbColumns(); j++){
+        if (cplex.getValue(lambda[j]) >= 0.9){
+            const PathColumn &column = columns[j];
+            for (unsigned int i = 0; i < column.arcs.size(); i++){
+                (*vecOnPath[column.demand])[column.arcs[i]] = getToBeRouted_k(column.demand).getId();
+            }
+        }
+    }
+    displayOnPath();
+}
+
+/* Displays the obtained paths. */
+void ColumnGeneration::displayOnPath(){
+    for(int d = 0; d < getNbDemandsToBeRouted(); d++){
+        std::cout << "For demand " << getToBeRouted_k(d).getId() + 1 << " : " << std::endl;
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            if ((*vecOnPath[d])[a] == getToBeRouted_k(d).getId()){
+                displayArc(d, a);
+            }
+        }
+    }
+}
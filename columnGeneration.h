@@ -0,0 +1,155 @@
+#ifndef __columnGeneration__h
+#define __columnGeneration__h
+
+#include "RSA.h"
+
+#include <ilcplex/ilocplex.h>
+
+/*********************************************************************************************
+* This structure stores a column of the path-based master problem: a path on one slice layer
+* of the extended graph associated with a demand.
+*********************************************************************************************/
+struct PathColumn {
+    int demand;                             /**< The index of the demand (i.e., of its graph) routed by the column. **/
+    int slice;                              /**< The last slice position assigned to the demand. **/
+    double cost;                            /**< The cost of the path according to the chosen metric. **/
+    double length;                          /**< The physical length of the path. **/
+    std::vector<ListDigraph::Arc> arcs;     /**< The arcs of the path on graph #demand. **/
+};
+
+/*********************************************************************************************
+* Read-only arc map returning costWeight*reducedCost + u[s]*length for an arc of slice layer s,
+* computed on the fly from flat arrays indexed by arc ids. Since slice layers are disjoint, a
+* single Dijkstra run prices every layer with its own multiplier.
+*********************************************************************************************/
+class LayerArcCost {
+public:
+    typedef ListDigraph::Arc Key;
+    typedef double Value;
+    LayerArcCost(const std::vector<double> &rc, const std::vector<double> &len, const std::vector<int> &sl, double w, const std::vector<double> &m) :
+        reducedCost(rc), length(len), slice(sl), costWeight(w), u(m) {}
+    Value operator[](const Key &a) const { int id = ListDigraph::id(a); return costWeight*reducedCost[id] + u[slice[id]]*length[id]; }
+private:
+    const std::vector<double> &reducedCost;
+    const std::vector<double> &length;
+    const std::vector<int> &slice;
+    const double costWeight;
+    const std::vector<double> &u;
+};
+
+/*********************************************************************************************
+* This class solves the Online Routing and Spectrum Allocation problem through a path-based
+* formulation and column generation (price-and-branch). Columns are (path, slice window)
+* pairs. The master problem selects one column per demand and forbids two selected columns
+* to overlap on the spectrum of a link. The pricing problem is, for each demand and each
+* slice layer of its extended graph, a length-constrained shortest path where the dual
+* values are folded into the arc costs. It is solved heuristically through Dijkstra on flat
+* Lagrangian costs c + u*length, moving u along at most MAX_NB_BREAKPOINTS breakpoints of the
+* (cost, length) hull. Slice layers are disjoint, so every layer is priced by the same
+* Dijkstra runs, started from all layer sources at once with one u per layer: a round costs a
+* few searches per graph. Since pricing is not exact, the LP value of the master is not a
+* lower bound. Each Dijkstra run at u gives one, though: no path within the length limit has
+* a reduced cost below its value minus u*maxLength. Adding, for each demand, the most negative
+* of these bounds to the LP value gives a valid (Lagrangian) lower bound. Once no column with
+* negative reduced cost is found, the master is solved with integer variables.
+*********************************************************************************************/
+class ColumnGeneration : public RSA {
+
+private:
+    const double EPSILON = 0.000001;
+    const int MAX_NB_COLUMNS_PER_DEMAND = 10;   /**< The maximal number of columns added for each demand in a pricing round. **/
+    const int MAX_NB_BREAKPOINTS = 10;          /**< The maximal number of Lagrangian costs tried when pricing a slice layer. **/
+
+    IloEnv env;                     /**< The CPLEX environment. **/
+    IloModel model;                 /**< The master problem. **/
+    IloCplex cplex;                 /**< The CPLEX engine. **/
+    IloObjective objective;         /**< The objective function of the master problem. **/
+    IloRangeArray convexity;        /**< convexity[d]: exactly one column is selected for the d-th demand. **/
+    IloRangeArray nonOverlap;       /**< nonOverlap[label*nbSlices + s]: at most one selected column occupies slice s of link label. **/
+    IloNumVarArray lambda;          /**< lambda[j] = 1 if the j-th column is selected. **/
+    IloNumVarArray artificial;      /**< artificial[d] = 1 if the d-th demand is not routed. **/
+
+    std::vector<PathColumn> columns;                        /**< The columns generated so far. columns[j] is associated with lambda[j]. **/
+    std::vector< std::vector<double> > vecFlatLength;        /**< vecFlatLength[d][id] is the length of the arc with the given id on graph #d. **/
+    std::vector< std::vector<double> > vecReducedCost;      /**< vecReducedCost[d][id] is the reduced cost of the arc with the given id on graph #d according to the current duals. **/
+    std::vector< std::vector<int> > vecFlatSlice;           /**< vecFlatSlice[d][id] is the slice layer of the arc with the given id on graph #d. **/
+    std::vector< std::vector<ListDigraph::Node> > vecLayerSource;  /**< vecLayerSource[d][s] is the source node of slice layer s on graph #d (or INVALID). **/
+    std::vector< std::vector<ListDigraph::Node> > vecLayerTarget;  /**< vecLayerTarget[d][s] is the target node of slice layer s on graph #d (or INVALID). **/
+
+    int nbSlices;                   /**< The largest number of slices among all links. **/
+    int iteration;                  /**< The number of pricing rounds performed. **/
+    const int MAX_NB_IT;            /**< The maximal number of pricing rounds. **/
+    double artificialCost;          /**< The cost of the artificial column of each demand, larger than the cost of any solution routing every demand. **/
+    double lpValue;                 /**< The value of the last solved linear relaxation of the master. **/
+    double lowerBound;              /**< The best Lagrangian lower bound found so far. **/
+    bool isFeasible;                /**< True if every demand has been routed. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Builds the master problem, generates columns and solves the integer master. @param instance The instance to be solved. **/
+    ColumnGeneration(const Instance &instance);
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+	/** Returns true if a solution routing every demand has been found. **/
+    bool getIsFeasible() const { return isFeasible; }
+
+	/** Returns the number of pricing rounds performed. **/
+    int getIteration() const { return iteration; }
+
+	/** Returns the number of generated columns. **/
+    int getNbColumns() const { return (int)columns.size(); }
+
+	/** Returns the value of the last solved linear relaxation of the master. @warning It is not a lower bound, since pricing is heuristic. **/
+    double getLpValue() const { return lpValue; }
+
+	/** Returns the best Lagrangian lower bound found during column generation. **/
+    double getLowerBound() const { return lowerBound; }
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+	/** Creates the master problem with one artificial column per demand. **/
+    void initMaster();
+
+	/** Returns a cost larger than the cost of any solution routing every demand: the sum over demands of the largest arc coefficient times the largest number of arcs of a path. **/
+    double computeArtificialCost();
+
+	/** Stores the flat arc lengths and slices and the source/target node of each slice layer of every graph. **/
+    void initPricing();
+
+	/** Adds a column to the master problem. @param column The column to be added. **/
+    void addColumn(const PathColumn &column);
+
+	/** Updates the reduced cost of every arc according to the duals of the last solved master. **/
+    void updateReducedCosts();
+
+	/** Searches for columns with negative reduced cost for the d-th demand and adds them to the master. Returns the number of columns added. @param d The graph #d. @param minReducedCost Receives a lower bound on the reduced cost of every column of the demand, convexity dual included. **/
+    int price(int d, double &minReducedCost);
+
+	/** Searches, on every slice layer of graph #d at once, for a path of small reduced cost respecting the demand's maximal length. @param d The graph #d. @param column column[s] receives the path found on layer s. @param found found[s] is true if layer s holds a path within the maximal length. @param bound bound[s] receives a lower bound on the reduced cost of every path of layer s within the maximal length (__DBL_MAX__ if there is none). **/
+    void priceLayers(int d, std::vector<PathColumn> &column, std::vector<bool> &found, std::vector<double> &bound);
+
+	/** Runs one Dijkstra on graph #d from the sources of every slice layer, with arc costs costWeight*reducedCost + u[s]*length on layer s, and stores in path[s] the path found to the target of layer s. @param reached reached[s] is true if the target of layer s is reached. **/
+    void shortestPaths(int d, double costWeight, const std::vector<double> &u, std::vector<PathColumn> &path, std::vector<bool> &reached);
+
+	/** Stores the path found by a Dijkstra run from the source to the target of slice layer s of graph #d. @param path The Dijkstra run. @param d The graph #d. @param s The slice layer. @param column The column to be filled. **/
+    void storePath(Dijkstra< ListDigraph, LayerArcCost > &path, int d, int s, PathColumn &column);
+
+	/** Returns the reduced cost of a path, without the dual of the convexity constraint. @param column The path. **/
+    double getPathReducedCost(const PathColumn &column);
+
+	/** Solves the master problem with integer variables and stores the selected paths on vecOnPath. **/
+    void solveIntegerMaster();
+
+	/****************************************************************************************/
+	/*										Display											*/
+	/****************************************************************************************/
+	/** Displays the obtained paths. **/
+    void displayOnPath();
+};
+
+#endif
@@ -0,0 +1,374 @@
+#include "compactForm.h"
+
+#include <algorithm>
+
+
+/* Constructor. Builds the compact Online RSA mixed-integer program and solves it using CPLEX. */
+CompactForm::CompactForm(const Instance &inst) : RSA(inst), model(env), cplex(model), x(env, getNbDemandsToBeRouted()),
+            z(env, getNbDemandsToBeRouted()), position(env, getNbDemandsToBeRouted()), order(env, getNbDemandsToBeRouted()), cost(env, getNbDemandsToBeRouted()),
+            compactArcIndex(compactGraph, -1), nbCompactArcs(0), nbSlices(0){
+    std::cout << "--- CPLEX (compact formulation) has been chosen ---" << std::endl;
+    for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+        compactArcIndex[a] = nbCompactArcs;
+        nbCompactArcs++;
+    }
+    for (int i = 0; i < instance.getNbEdges(); i++){
+        nbSlices = std::max(nbSlices, instance.getPhysicalLinkFromId(i).getNbSlices());
+    }
+    /************************************************/
+	/*				    SET VARIABLES				*/
+	/************************************************/
+    setVariables();
+    std::cout << "Variables have been defined..." << std::endl;
+
+	/************************************************/
+	/*			    SET OBJECTIVE FUNCTION			*/
+	/************************************************/
+    setObjective();
+    std::cout << "Objective function has been defined..." << std::endl;
+
+	/************************************************/
+	/*			      SET CONSTRAINTS				*/
+	/************************************************/
+    setFlowConstraints();
+    std::cout << "Flow constraints have been defined..." << std::endl;
+
+    setSliceConstraints();
+    std::cout << "Slice constraints have been defined..." << std::endl;
+
+    setLengthConstraints();
+    std::cout << "Length constraints have been defined..." << std::endl;
+
+    setAvailabilityConstraints();
+    std::cout << "Availability constraints have been defined..." << std::endl;
+
+    setNonOverlappingConstraints();
+    std::cout << "Non-Overlapping constraints have been defined..." << std::endl;
+
+    setSymmetryBreakingConstraints();
+    std::cout << "Symmetry-breaking constraints have been defined..." << std::endl;
+
+	/************************************************/
+	/*             DEFINE CPLEX PARAMETERS   		*/
+	/************************************************/
+    cplex.setParam(IloCplex::Param::MIP::Display, 2);
+    std::cout << "CPLEX parameters have been defined..." << std::endl;
+
+	/************************************************/
+	/*		         SOLVE LINEAR PROGRAM   		*/
+	/************************************************/
+    IloNum timeStart = cplex.getCplexTime();
+    std::cout << "Solving..." << std::endl;
+    cplex.solve();
+    std::cout << "Solved!" << std::endl;
+    IloNum timeFinish = cplex.getCplexTime();
+
+	/************************************************/
+	/*		    GET OPTIMAL SOLUTION FOUND        	*/
+	/************************************************/
+    if (cplex.getStatus() == IloAlgorithm::Optimal){
+        std::cout << "Optimization done in " << timeFinish - timeStart << " secs." << std::endl;
+        std::cout << "Objective Function Value: " << cplex.getObjValue() << std::endl;
+        updatePath();
+        displayOnPath();
+    }
+    else{
+        std::cout << "Could not find a path!" << std::endl;
+    }
+}
+
+/* Returns the expression counting how many times the d-th demand uses the i-th compact arc (in any direction). */
+IloExpr CompactForm::getEdgeUsage(int d, const ListDigraph::Arc &a){
+    IloExpr exp(env);
+    exp += x[d][getCompactArcVar(a, 0)];
+    exp += x[d][getCompactArcVar(a, 1)];
+    return exp;
+}
+
+/* Returns true if the window of slices ending on position s can be assigned to the d-th demand on a link. */
+bool CompactForm::isWindowFree(int label, int s, int d){
+    if (s >= instance.getPhysicalLinkFromId(label).getNbSlices()){
+        return false;
+    }
+    return instance.hasEnoughSpace(label, s, getToBeRouted_k(d));
+}
+
+/* Defines edge variables x, slice position variables z and position, and ordering variables. */
+void CompactForm::setVariables(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const Demand demand = getToBeRouted_k(d);
+        x[d] = IloNumVarArray(env, 2*nbCompactArcs);
+        for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+            for (int dir = 0; dir <= 1; dir++){
+                std::string varName = "x(" + std::to_string(demand.getId() + 1) + "," + std::to_string(getCompactTail(a, dir) + 1) + ",";
+                varName += std::to_string(getCompactHead(a, dir) + 1) + ")";
+                IloNum upperBound = 1.0;
+                if (getCompactHead(a, dir) == demand.getSource() || getCompactTail(a, dir) == demand.getTarget()){
+                    upperBound = 0.0;
+                }
+                x[d][getCompactArcVar(a, dir)] = IloNumVar(env, 0.0, upperBound, ILOINT, varName.c_str());
+                model.add(x[d][getCompactArcVar(a, dir)]);
+            }
+        }
+        z[d] = IloNumVarArray(env, nbSlices);
+        for (int s = 0; s < nbSlices; s++){
+            std::string varName = "z(" + std::to_string(demand.getId() + 1) + "," + std::to_string(s + 1) + ")";
+            IloNum upperBound = 1.0;
+            if (s < demand.getLoad() - 1){
+                upperBound = 0.0;
+            }
+            z[d][s] = IloNumVar(env, 0.0, upperBound, ILOINT, varName.c_str());
+            model.add(z[d][s]);
+        }
+        std::string positionName = "p(" + std::to_string(demand.getId() + 1) + ")";
+        position[d] = IloNumVar(env, demand.getLoad() - 1, std::max(demand.getLoad() - 1, nbSlices - 1), ILOINT, positionName.c_str());
+        model.add(position[d]);
+        order[d] = IloNumVarArray(env, getNbDemandsToBeRouted());
+        for (int d2 = d + 1; d2 < getNbDemandsToBeRouted(); d2++){
+            std::string varName = "o(" + std::to_string(demand.getId() + 1) + "," + std::to_string(getToBeRouted_k(d2).getId() + 1) + ")";
+            order[d][d2] = IloNumVar(env, 0.0, 1.0, ILOINT, varName.c_str());
+            model.add(order[d][d2]);
+        }
+        if (instance.getInput().getChosenObj() == Input::OBJECTIVE_METRIC_1p){
+            cost[d] = IloNumVarArray(env, 2*nbCompactArcs);
+            for (int k = 0; k < 2*nbCompactArcs; k++){
+                std::string varName = "c(" + std::to_string(demand.getId() + 1) + "," + std::to_string(k + 1) + ")";
+                cost[d][k] = IloNumVar(env, 0.0, IloInfinity, ILOFLOAT, varName.c_str());
+                model.add(cost[d][k]);
+            }
+        }
+    }
+}
+
+/* Defines the objective function according to the chosen metric. */
+void CompactForm::setObjective(){
+    IloExpr obj(env);
+    int maxSliceUsed = 0;
+    for (int i = 0; i < instance.getNbEdges(); i++){
+        maxSliceUsed = std::max(maxSliceUsed, instance.getPhysicalLinkFromId(i).getMaxUsedSlicePosition());
+    }
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const Demand demand = getToBeRouted_k(d);
+        switch (instance.getInput().getChosenObj()){
+            case Input::OBJECTIVE_METRIC_1:
+            case Input::OBJECTIVE_METRIC_8:
+            {
+                /* The arc leaving the source costs its slice position (+1); every other arc costs 1. */
+                for (int s = demand.getLoad() - 1; s < nbSlices; s++){
+                    double coeff = s + 1;
+                    if (instance.getInput().getChosenObj() == Input::OBJECTIVE_METRIC_8){
+                        coeff = std::max(s, maxSliceUsed) + 1;
+                    }
+                    obj += coeff*z[d][s];
+                }
+                for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+                    for (int dir = 0; dir <= 1; dir++){
+                        if (getCompactTail(a, dir) != demand.getSource()){
+                            obj += x[d][getCompactArcVar(a, dir)];
+                        }
+                    }
+                }
+                break;
+            }
+            case Input::OBJECTIVE_METRIC_1p:
+            {
+                /* Each arc costs max(slice position, max used slice position on its link). */
+                for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+                    int maxSliceUsedOnLink = instance.getPhysicalLinkFromId(compactArcLabel[a]).getMaxUsedSlicePosition();
+                    for (int dir = 0; dir <= 1; dir++){
+                        int k = getCompactArcVar(a, dir);
+                        model.add(cost[d][k] - maxSliceUsedOnLink*x[d][k] >= 0);
+                        model.add(cost[d][k] - position[d] - nbSlices*x[d][k] >= -nbSlices);
+                        obj += cost[d][k];
+                    }
+                }
+                break;
+            }
+            case Input::OBJECTIVE_METRIC_2:
+            {
+                for (int k = 0; k < 2*nbCompactArcs; k++){
+                    obj += x[d][k];
+                }
+                break;
+            }
+            case Input::OBJECTIVE_METRIC_4:
+            {
+                for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+                    obj += compactArcLength[a]*getEdgeUsage(d, a);
+                }
+                break;
+            }
+            default:
+            {
+                std::cerr << "Objective metric out of range.\n";
+                exit(0);
+                break;
+            }
+        }
+    }
+    model.add(IloMinimize(env, obj));
+    obj.end();
+}
+
+/* Flow constraints on the compact graph. */
+void CompactForm::setFlowConstraints(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const Demand demand = getToBeRouted_k(d);
+        for (ListDigraph::NodeIt v(compactGraph); v != INVALID; ++v){
+            int label = compactNodeLabel[v];
+            IloExpr out(env);
+            IloExpr in(env);
+            for (ListDigraph::OutArcIt a(compactGraph, v); a != INVALID; ++a){
+                out += x[d][getCompactArcVar(a, 0)];
+                in += x[d][getCompactArcVar(a, 1)];
+            }
+            for (ListDigraph::InArcIt a(compactGraph, v); a != INVALID; ++a){
+                out += x[d][getCompactArcVar(a, 1)];
+                in += x[d][getCompactArcVar(a, 0)];
+            }
+            IloInt rhs = 0;
+            if (label == demand.getSource()){
+                rhs = 1;
+            }
+            if (label == demand.getTarget()){
+                rhs = -1;
+            }
+            std::string flowName = "Flow(" + std::to_string(label + 1) + "," + std::to_string(demand.getId() + 1) + ")";
+            model.add(IloRange(env, rhs, out - in, rhs, flowName.c_str()));
+            std::string degreeName = "Degree(" + std::to_string(label + 1) + "," + std::to_string(demand.getId() + 1) + ")";
+            model.add(IloRange(env, -IloInfinity, out, 1, degreeName.c_str()));
+            out.end();
+            in.end();
+        }
+    }
+}
+
+/* Exactly one last slice position is assigned to each demand, and position is the slice it designates. */
+void CompactForm::setSliceConstraints(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        IloExpr exp(env);
+        IloExpr weighted(env);
+        for (int s = 0; s < nbSlices; s++){
+            exp += z[d][s];
+            weighted += s*z[d][s];
+        }
+        std::string constraintName = "Slice(" + std::to_string(getToBeRouted_k(d).getId() + 1) + ")";
+        model.add(IloRange(env, 1, exp, 1, constraintName.c_str()));
+        std::string positionName = "Position(" + std::to_string(getToBeRouted_k(d).getId() + 1) + ")";
+        model.add(IloRange(env, 0, position[d] - weighted, 0, positionName.c_str()));
+        exp.end();
+        weighted.end();
+    }
+}
+
+/* Length constraints. Demands must be routed within a length limit. */
+void CompactForm::setLengthConstraints(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        IloExpr exp(env);
+        for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+            exp += compactArcLength[a]*getEdgeUsage(d, a);
+        }
+        std::string constraintName = "Length(" + std::to_string(getToBeRouted_k(d).getId() + 1) + ")";
+        model.add(IloRange(env, -IloInfinity, exp, getToBeRouted_k(d).getMaxLength(), constraintName.c_str()));
+        exp.end();
+    }
+}
+
+/* Availability constraints. For each position s, the edges whose window ending on s is occupied can only be used if s is not chosen. */
+void CompactForm::setAvailabilityConstraints(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        for (int s = getToBeRouted_k(d).getLoad() - 1; s < nbSlices; s++){
+            IloExpr exp(env);
+            int nbBlocked = 0;
+            for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+                if (isWindowFree(compactArcLabel[a], s, d) == false){
+                    exp += getEdgeUsage(d, a);
+                    nbBlocked++;
+                }
+            }
+            if (nbBlocked > 0){
+                exp += nbBlocked*z[d][s];
+                std::string constraintName = "Available(" + std::to_string(s + 1) + "," + std::to_string(getToBeRouted_k(d).getId() + 1) + ")";
+                model.add(IloRange(env, -IloInfinity, exp, nbBlocked, constraintName.c_str()));
+            }
+            exp.end();
+        }
+    }
+}
+
+/* Non-overlapping constraints. If d1 is below d2 on a shared edge, the last slice of d1 is smaller than the first slice of d2 and vice-versa. */
+void CompactForm::setNonOverlappingConstraints(){
+    for (int d1 = 0; d1 < getNbDemandsToBeRouted(); d1++){
+        for (int d2 = d1 + 1; d2 < getNbDemandsToBeRouted(); d2++){
+            const int load1 = getToBeRouted_k(d1).getLoad();
+            const int load2 = getToBeRouted_k(d2).getLoad();
+            const int bigM = nbSlices + std::max(load1, load2);
+            for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+                IloExpr shared = getEdgeUsage(d1, a) + getEdgeUsage(d2, a);
+                std::string constraintName = "Subcycle(" + std::to_string(compactArcLabel[a] + 1) + "," + std::to_string(getToBeRouted_k(d1).getId() + 1) + "," + std::to_string(getToBeRouted_k(d2).getId() + 1) + ")";
+                model.add(IloRange(env, -IloInfinity, position[d1] - position[d2] + bigM*order[d1][d2] + bigM*shared, 3*bigM - load2, (constraintName + "_a").c_str()));
+                model.add(IloRange(env, -IloInfinity, position[d2] - position[d1] - bigM*order[d1][d2] + bigM*shared, 2*bigM - load1, (constraintName + "_b").c_str()));
+                shared.end();
+            }
+        }
+    }
+}
+
+/* Symmetry-breaking constraints. The last slice of an identical demand d1 < d2 is not larger than the one of d2, and d1 is below d2 whenever they share an edge. */
+void CompactForm::setSymmetryBreakingConstraints(){
+    for (int d2 = 0; d2 < getNbDemandsToBeRouted(); d2++){
+        int d1 = getSymmetricPredecessor(d2);
+        if (d1 != -1){
+            std::string constraintName = "Symmetry(" + std::to_string(getToBeRouted_k(d1).getId() + 1) + "," + std::to_string(getToBeRouted_k(d2).getId() + 1) + ")";
+            model.add(IloRange(env, -IloInfinity, position[d1] - position[d2], 0, constraintName.c_str()));
+            order[d1][d2].setLB(1.0);
+        }
+    }
+}
+
+/* Recovers the obtained MIP solution and builds a path for each demand on its associated extended graph from RSA. */
+void CompactForm::updatePath(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const Demand demand = getToBeRouted_k(d);
+        int position = -1;
+        for (int s = 0; s < nbSlices; s++){
+            if (cplex.getValue(z[d][s]) >= 0.9){
+                position = s;
+            }
+        }
+        /* linkTail[label] is the label of the node from which the demand leaves through link label (-1 if not used). */
+        std::vector<int> linkTail(instance.getNbEdges(), -1);
+        for (ListDigraph::ArcIt a(compactGraph); a != INVALID; ++a){
+            for (int dir = 0; dir <= 1; dir++){
+                if (cplex.getValue(x[d][getCompactArcVar(a, dir)]) >= 0.9){
+                    linkTail[compactArcLabel[a]] = getCompactTail(a, dir);
+                }
+            }
+        }
+        int nbArcsOnPath = 0;
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            (*vecOnPath[d])[a] = -1;
+            int label = getArcLabel(a, d);
+            if (getArcSlice(a, d) == position && linkTail[label] != -1 && linkTail[label] == getNodeLabel((*vecGraph[d]).source(a), d)){
+                (*vecOnPath[d])[a] = demand.getId();
+                nbArcsOnPath++;
+            }
+        }
+        int nbLinksUsed = (int)std::count_if(linkTail.begin(), linkTail.end(), [](int tail){ return tail != -1; });
+        if (nbArcsOnPath != nbLinksUsed){
+            std::cerr << "WARNING: Only " << nbArcsOnPath << " out of " << nbLinksUsed << " arcs were found on the extended graph of demand " << demand.getId() + 1 << "." << std::endl;
+        }
+    }
+}
+
+/* Displays the obtained paths. */
+void CompactForm::displayOnPath(){
+    for(int d = 0; d < getNbDemandsToBeRouted(); d++){
+        std::cout << "For demand " << getToBeRouted_k(d).getId() + 1 << " : " << std::endl;
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            if ((*vecOnPath[d])[a] == getToBeRouted_k(d).getId()){
+                displayArc(d, a);
+            }
+        }
+    }
+}
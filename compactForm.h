@@ -0,0 +1,102 @@
+#ifndef __compactForm__h
+#define __compactForm__h
+
+#include "RSA.h"
+
+#include <ilcplex/ilocplex.h>
+
+typedef IloArray<IloNumVarArray> IloNumVarMatrix;
+
+
+/*********************************************************************************************
+* This class implements and solves a compact Online Routing and Spectrum Allocation MIP using
+* CPLEX. Instead of one variable per arc of the extended graphs, each demand has one variable
+* per direction of every edge of the compact graph and one variable per possible last slice
+* position. Spectrum continuity is implied by the single slice position variable of each
+* demand, and two demands sharing an edge are ordered on the spectrum through one binary
+* variable per pair. The model size no longer depends on the number of slices times the
+* number of edges, so it remains small for large spectra and large batches of demands.
+* \note The obtained solution is mapped back to the extended graphs (i.e., to vecOnPath).
+*********************************************************************************************/
+class CompactForm : public RSA{
+
+private:
+    IloEnv env;			        /**< The CPLEX environment. **/
+    IloModel model;		        /**< The CPLEX model. **/
+    IloCplex cplex;		        /**< The CPLEX engine. **/
+    IloNumVarMatrix x;	        /**< x[d][2*i + dir] = 1 if the d-th demand is routed through the i-th compact arc, forward (dir = 0) or backward (dir = 1). **/
+    IloNumVarMatrix z;	        /**< z[d][s] = 1 if the last slice assigned to the d-th demand is s. **/
+    IloNumVarArray position;    /**< position[d] is the last slice position assigned to the d-th demand. It is tied to z[d] by a single row, so that the big-M, symmetry and cost rows stay short. **/
+    IloNumVarMatrix order;	    /**< order[d1][d2] = 1 if demand d1 is placed below demand d2 on the spectrum (only defined for d1 < d2). **/
+    IloNumVarMatrix cost;	    /**< cost[d][2*i + dir] is the cost of the d-th demand on the i-th compact arc. Only used by metric 1p. **/
+    ArcMap compactArcIndex;     /**< The index of each arc of the compact graph in [0, ..., nbArcs-1]. **/
+    int nbCompactArcs;          /**< The number of arcs of the compact graph. **/
+    int nbSlices;               /**< The largest number of slices among all links. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Builds the compact Online RSA mixed-integer program and solves it using CPLEX.  @param instance The instance to be solved. **/
+    CompactForm(const Instance &instance);
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+	/** Returns the cplex engine in use. **/
+    IloCplex getCplex(){ return cplex; }
+
+	/** Returns the index of the variable associated with a compact arc used in a given direction. @param a The compact arc. @param dir 0 if forward, 1 if backward. **/
+    int getCompactArcVar(const ListDigraph::Arc &a, int dir) const { return 2*compactArcIndex[a] + dir; }
+
+	/** Returns the label of the tail of a compact arc used in a given direction. @param a The compact arc. @param dir 0 if forward, 1 if backward. **/
+    int getCompactTail(const ListDigraph::Arc &a, int dir) const { return (dir == 0) ? compactNodeLabel[compactGraph.source(a)] : compactNodeLabel[compactGraph.target(a)]; }
+
+	/** Returns the label of the head of a compact arc used in a given direction. @param a The compact arc. @param dir 0 if forward, 1 if backward. **/
+    int getCompactHead(const ListDigraph::Arc &a, int dir) const { return (dir == 0) ? compactNodeLabel[compactGraph.target(a)] : compactNodeLabel[compactGraph.source(a)]; }
+
+	/** Returns the expression counting how many times the d-th demand uses the i-th compact arc (in any direction). @param d The demand index. @param a The compact arc. **/
+    IloExpr getEdgeUsage(int d, const ListDigraph::Arc &a);
+
+	/** Returns true if the window of slices ending on position s can be assigned to the d-th demand on a link. @param label The link label. @param s The last slice position. @param d The demand index. **/
+    bool isWindowFree(int label, int s, int d);
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+	/** Defines edge variables x, slice position variables z and position, and ordering variables. **/
+    void setVariables();
+
+	/** Defines the objective function according to the chosen metric. **/
+    void setObjective();
+
+	/** Flow constraints on the compact graph. One unit leaves the source, one unit enters the target, at most one leaves each node and none enters the source. **/
+    void setFlowConstraints();
+
+	/** Exactly one last slice position is assigned to each demand, and position is the slice it designates. **/
+    void setSliceConstraints();
+
+	/** Length constraints. Demands must be routed within a length limit. **/
+    void setLengthConstraints();
+
+	/** Availability constraints. An edge cannot be used if the slice window of the demand is already occupied on its link. **/
+    void setAvailabilityConstraints();
+
+	/** Non-overlapping constraints. Two demands sharing an edge must be assigned to disjoint slice windows. **/
+    void setNonOverlappingConstraints();
+
+	/** Symmetry-breaking constraints. Identical demands are placed on the spectrum in increasing index order. **/
+    void setSymmetryBreakingConstraints();
+
+	/** Recovers the obtained MIP solution and builds a path for each demand on its associated extended graph from RSA. **/
+    void updatePath();
+
+	/****************************************************************************************/
+	/*										Display											*/
+	/****************************************************************************************/
+	/** Displays the obtained paths. **/
+    void displayOnPath();
+};
+
+
+#endif
@@ -0,0 +1,306 @@
+#include "cplexBackend.h"
+
+#include <thread>
+#include <numeric>
+
+/* Constructor. */
+CplexBackend::CplexBackend(int threads, bool names) : RoutingBackend(), env(NULL), lp(NULL), status(0), nbThreads(threads), withNames(names){
+    int error = 0;
+    env = CPXopenCPLEX(&error);
+    checkError(error, "CPXopenCPLEX");
+    lp = CPXcreateprob(env, &error, "RSA");
+    checkError(error, "CPXcreateprob");
+}
+
+/* Destructor. Frees the CPLEX problem and environment. */
+CplexBackend::~CplexBackend(){
+    if (lp != NULL){
+        CPXfreeprob(env, &lp);
+    }
+    if (env != NULL){
+        CPXcloseCPLEX(&env);
+    }
+}
+
+/* Aborts the program if a CPLEX routine has failed. */
+void CplexBackend::checkError(int error, std::string routine){
+    if (error != 0){
+        char message[CPXMESSAGEBUFSIZE];
+        std::cerr << "ERROR: " << routine << " failed with code " << error << ". ";
+        if (CPXgeterrorstring(env, error, message) != NULL){
+            std::cerr << message;
+        }
+        std::cerr << std::endl;
+        abort();
+    }
+}
+
+/* Builds the MIP, solves it and returns true if an optimal solution has been found. */
+bool CplexBackend::solve(){
+	/************************************************/
+	/*		    ASSEMBLE AND LOAD THE MODEL			*/
+	/************************************************/
+    double timeStart = 0.0, timeAssembled = 0.0, timeLoaded = 0.0;
+    CPXgettime(env, &timeStart);
+    buildModel();
+    CPXgettime(env, &timeAssembled);
+    std::cout << "Model has been assembled in " << timeAssembled - timeStart << " secs..." << std::endl;
+    loadModel();
+    CPXgettime(env, &timeLoaded);
+    std::cout << "Model has been loaded in " << timeLoaded - timeAssembled << " secs (";
+    std::cout << CPXgetnumcols(env, lp) << " columns, " << CPXgetnumrows(env, lp) << " rows)..." << std::endl;
+
+	/************************************************/
+	/*		         SOLVE LINEAR PROGRAM   		*/
+	/************************************************/
+    checkError(CPXsetintparam(env, CPXPARAM_MIP_Display, 2), "CPXsetintparam");
+    if (nbThreads > 0){
+        checkError(CPXsetintparam(env, CPXPARAM_Threads, nbThreads), "CPXsetintparam");
+    }
+    checkError(CPXmipopt(env, lp), "CPXmipopt");
+    status = CPXgetstat(env, lp);
+    if (!isOptimal()){
+        return false;
+    }
+    checkError(CPXgetobjval(env, lp, &objValue), "CPXgetobjval");
+    const int nbColumns = (int)obj.size();
+    std::vector<double> solution(nbColumns);
+    if (nbColumns > 0){
+        checkError(CPXgetx(env, lp, solution.data(), 0, nbColumns - 1), "CPXgetx");
+    }
+    for (int d = 0; d < getNbDemands(); d++){
+        for (unsigned int i = 0; i < demands[d].arcs.size(); i++){
+            onPath[d][i] = (solution[columnOffset[d] + i] >= 0.9);
+        }
+    }
+    return true;
+}
+
+/* Assembles every column and row of the model, using nbThreads threads for the rows. */
+void CplexBackend::buildModel(){
+    buildColumns();
+    rowBlock.assign(getNbDemands(), RowBlock());
+    int nbWorkers = nbThreads;
+    if (nbWorkers <= 0){
+        nbWorkers = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    nbWorkers = std::min(nbWorkers, getNbDemands());
+    if (nbWorkers <= 1){
+        buildRows(0, getNbDemands(), 1);
+        return;
+    }
+    /* Each thread writes only the blocks of its own demands and reads the columns of every demand. */
+    std::vector<std::thread> workers;
+    for (int t = 0; t < nbWorkers; t++){
+        workers.emplace_back(&CplexBackend::buildRows, this, t, getNbDemands(), nbWorkers);
+    }
+    for (unsigned int t = 0; t < workers.size(); t++){
+        workers[t].join();
+    }
+}
+
+/* Fills the columns (objective, bounds and names) and the slice index of every demand. */
+void CplexBackend::buildColumns(){
+    int nbColumns = 0;
+    columnOffset.clear();
+    obj.clear();
+    ub.clear();
+    colName.clear();
+    sliceColumns.assign(getNbDemands(), std::vector< std::vector<int> >(nbLinks*nbSlices));
+    for (int d = 0; d < getNbDemands(); d++){
+        columnOffset.push_back(nbColumns);
+        for (unsigned int i = 0; i < demands[d].arcs.size(); i++){
+            const RoutingArc &arc = demands[d].arcs[i];
+            obj.push_back(arc.cost);
+            ub.push_back(arc.isAvailable ? 1.0 : 0.0);
+            if (withNames){
+                colName.push_back("x(" + std::to_string(demands[d].id + 1) + "," + std::to_string(arc.tail + 1) + "," + std::to_string(arc.head + 1) + "," + std::to_string(arc.slice + 1) + ")");
+            }
+            sliceColumns[d][arc.label*nbSlices + arc.slice].push_back(nbColumns);
+            nbColumns++;
+        }
+    }
+}
+
+/* Fills the rows of every demand with index in [first, ..., last) by steps of step. */
+void CplexBackend::buildRows(int first, int last, int step){
+    for (int d = first; d < last; d += step){
+        buildRoutingRows(d, rowBlock[d]);
+        buildNonOverlappingRows(d, rowBlock[d]);
+        buildSymmetryBreakingRows(d, rowBlock[d]);
+    }
+}
+
+/* Loads the assembled arrays into CPLEX with one CPXaddcols and one CPXaddrows call. */
+void CplexBackend::loadModel(){
+    const int nbColumns = (int)obj.size();
+
+    /* Columns are created empty: their coefficients are given row-wise by CPXaddrows. */
+    std::vector<double> lb(nbColumns, 0.0);
+    std::vector<int> cmatbeg(nbColumns, 0);
+    int cmatind[1] = {0};
+    double cmatval[1] = {0.0};
+    std::vector<char*> colNamePtr;
+    if (withNames){
+        for (int i = 0; i < nbColumns; i++){
+            colNamePtr.push_back(const_cast<char*>(colName[i].c_str()));
+        }
+    }
+    checkError(CPXaddcols(env, lp, nbColumns, 0, obj.data(), cmatbeg.data(), cmatind, cmatval, lb.data(), ub.data(), withNames ? colNamePtr.data() : NULL), "CPXaddcols");
+
+    std::vector<int> indices(nbColumns);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::vector<char> ctype(nbColumns, 'B');
+    checkError(CPXchgctype(env, lp, nbColumns, indices.data(), ctype.data()), "CPXchgctype");
+
+    RowBlock rows;
+    for (int d = 0; d < getNbDemands(); d++){
+        rows.append(rowBlock[d]);
+        rowBlock[d] = RowBlock();
+    }
+    std::vector<char*> rowNamePtr;
+    if (withNames){
+        for (int i = 0; i < rows.getNbRows(); i++){
+            rowNamePtr.push_back(const_cast<char*>(rows.name[i].c_str()));
+        }
+    }
+    checkError(CPXaddrows(env, lp, 0, rows.getNbRows(), (int)rows.rmatind.size(), rows.rhs.data(), rows.sense.data(), rows.rmatbeg.data(),
+                            rows.rmatind.data(), rows.rmatval.data(), NULL, withNames ? rowNamePtr.data() : NULL), "CPXaddrows");
+}
+
+/* Fills the source, flow conservation, target and length rows of the d-th demand. */
+void CplexBackend::buildRoutingRows(int d, RowBlock &rows){
+    const RoutingDemand &demand = demands[d];
+    const int id = demand.id + 1;
+
+    /* Source constraints. At most 1 leaves each label. Exactly 1 leaves the Source. None leaves the Target. */
+    std::vector< std::vector<int> > outColumns(nbNodes);
+    std::vector<bool> hasLabel(nbNodes, false);
+    /* Flow constraints are stated on every node (label, slice). */
+    std::vector< std::vector<int> > nodeOut(nbNodes*nbSlices), nodeIn(nbNodes*nbSlices);
+    hasLabel[demand.source] = true;
+    for (unsigned int i = 0; i < demand.arcs.size(); i++){
+        const RoutingArc &arc = demand.arcs[i];
+        int col = columnOffset[d] + i;
+        hasLabel[arc.tail] = true;
+        hasLabel[arc.head] = true;
+        outColumns[arc.tail].push_back(col);
+        nodeOut[arc.tail*nbSlices + arc.slice].push_back(col);
+        nodeIn[arc.head*nbSlices + arc.slice].push_back(col);
+    }
+    for (int label = 0; label < nbNodes; label++){
+        if (hasLabel[label]){
+            if (label == demand.source){
+                rows.newRow('E', 1.0);
+            }
+            else if (label == demand.target){
+                rows.newRow('E', 0.0);
+            }
+            else{
+                rows.newRow('L', 1.0);
+            }
+            for (unsigned int k = 0; k < outColumns[label].size(); k++){
+                rows.addCoeff(outColumns[label][k], 1.0);
+            }
+            if (withNames){
+                rows.name.push_back("Source(" + std::to_string(label + 1) + "," + std::to_string(id) + ")");
+            }
+        }
+    }
+    for (int label = 0; label < nbNodes; label++){
+        if (label == demand.source || label == demand.target){
+            continue;
+        }
+        for (int slice = 0; slice < nbSlices; slice++){
+            const std::vector<int> &out = nodeOut[label*nbSlices + slice];
+            const std::vector<int> &in = nodeIn[label*nbSlices + slice];
+            if (out.empty() && in.empty()){
+                continue;
+            }
+            rows.newRow('E', 0.0);
+            for (unsigned int k = 0; k < out.size(); k++){
+                rows.addCoeff(out[k], 1.0);
+            }
+            for (unsigned int k = 0; k < in.size(); k++){
+                rows.addCoeff(in[k], -1.0);
+            }
+            if (withNames){
+                rows.name.push_back("Flow(" + std::to_string(label + 1) + "," + std::to_string(slice + 1) + "," + std::to_string(id) + ")");
+            }
+        }
+    }
+
+    /* Target constraints. Only 1 enters the Target. */
+    rows.newRow('E', 1.0);
+    for (unsigned int i = 0; i < demand.arcs.size(); i++){
+        if (demand.arcs[i].head == demand.target){
+            rows.addCoeff(columnOffset[d] + i, 1.0);
+        }
+    }
+    if (withNames){
+        rows.name.push_back("Target(" + std::to_string(id) + ")");
+    }
+
+    /* Length constraints. Demands must be routed within a length limit. */
+    rows.newRow('L', demand.maxLength);
+    for (unsigned int i = 0; i < demand.arcs.size(); i++){
+        rows.addCoeff(columnOffset[d] + i, demand.arcs[i].length);
+    }
+    if (withNames){
+        rows.name.push_back("Length(" + std::to_string(id) + ")");
+    }
+}
+
+/* Fills the non-overlapping rows between the d-th demand and every other demand. */
+void CplexBackend::buildNonOverlappingRows(int d, RowBlock &rows){
+    for (int label = 0; label < nbLinks; label++){
+        for (int slice = 0; slice < nbSlices; slice++){
+            const std::vector<int> &columns1 = sliceColumns[d][label*nbSlices + slice];
+            if (columns1.empty()){
+                continue;
+            }
+            for (int d2 = 0; d2 < getNbDemands(); d2++){
+                if (d2 == d){
+                    continue;
+                }
+                rows.newRow('L', 1.0);
+                for (unsigned int k = 0; k < columns1.size(); k++){
+                    rows.addCoeff(columns1[k], 1.0);
+                }
+                int firstSlice = std::max(0, slice - demands[d].load + 1);
+                int lastSlice = std::min(nbSlices - 1, slice + demands[d2].load - 1);
+                for (int s = firstSlice; s <= lastSlice; s++){
+                    const std::vector<int> &columns2 = sliceColumns[d2][label*nbSlices + s];
+                    for (unsigned int k = 0; k < columns2.size(); k++){
+                        rows.addCoeff(columns2[k], 1.0);
+                    }
+                }
+                if (withNames){
+                    rows.name.push_back("Subcycle(" + std::to_string(label + 1) + "," + std::to_string(slice + 1) + "," + std::to_string(demands[d].id + 1) + "," + std::to_string(demands[d2].id + 1) + ")");
+                }
+            }
+        }
+    }
+}
+
+/* Fills the row ordering the d-th demand after the previous identical demand, if any. */
+void CplexBackend::buildSymmetryBreakingRows(int d, RowBlock &rows){
+    int d1 = demands[d].symmetricPredecessor;
+    if (d1 == -1){
+        return;
+    }
+    rows.newRow('L', 0.0);
+    for (unsigned int i = 0; i < demands[d1].arcs.size(); i++){
+        if (demands[d1].arcs[i].tail == demands[d1].source){
+            rows.addCoeff(columnOffset[d1] + i, demands[d1].arcs[i].slice);
+        }
+    }
+    for (unsigned int i = 0; i < demands[d].arcs.size(); i++){
+        if (demands[d].arcs[i].tail == demands[d].source){
+            rows.addCoeff(columnOffset[d] + i, -demands[d].arcs[i].slice);
+        }
+    }
+    if (withNames){
+        rows.name.push_back("Symmetry(" + std::to_string(demands[d1].id + 1) + "," + std::to_string(demands[d].id + 1) + ")");
+    }
+}
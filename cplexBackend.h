@@ -0,0 +1,84 @@
+#ifndef __cplexBackend__h
+#define __cplexBackend__h
+
+#include "routingBackend.h"
+#include "rowBlock.h"
+
+#include <ilcplex/cplex.h>
+
+/*********************************************************************************************
+* This class is the RoutingBackend solving the model as a MIP with the CPLEX Callable Library.
+* There is one binary column per arc and the rows are the same as in the arc-based formulation
+* from Solver (source, flow conservation, target, length, non-overlapping and symmetry
+* breaking). The rows of each demand are assembled in compressed sparse row format (possibly
+* by several threads, one set of demands per thread) and everything is loaded with a single
+* CPXaddcols and a single CPXaddrows call. CplexBulkForm is a client of this backend.
+* \note It is the only backend requiring CPLEX. It is not compiled when NO_CPLEX is defined.
+*********************************************************************************************/
+class CplexBackend : public RoutingBackend {
+
+private:
+    CPXENVptr env;                      /**< The CPLEX environment. **/
+    CPXLPptr lp;                        /**< The CPLEX problem. **/
+    int status;                         /**< The CPLEX solution status obtained after optimization. **/
+    int nbThreads;                      /**< The number of threads CPLEX may use and the model is assembled with. If non-positive, CPLEX decides. **/
+    bool withNames;                     /**< If true, names are given to columns and rows. **/
+
+    std::vector<int> columnOffset;      /**< columnOffset[d] is the index of the first column associated with the d-th demand. **/
+    std::vector<double> obj;            /**< The objective coefficient of each column. **/
+    std::vector<double> ub;             /**< The upper bound of each column. **/
+    std::vector<std::string> colName;   /**< The name of each column. @note Left empty if names are not required. **/
+    std::vector<RowBlock> rowBlock;     /**< rowBlock[d] stores the rows associated with the d-th demand. **/
+    std::vector< std::vector< std::vector<int> > > sliceColumns;  /**< sliceColumns[d][label*nbSlices + slice] stores the columns of the d-th demand whose arcs have the given label and slice. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. @param threads The number of threads CPLEX may use. If non-positive, CPLEX decides. @param names If true, names are given to columns and rows. **/
+    CplexBackend(int threads = 0, bool names = false);
+
+	/** Destructor. Frees the CPLEX problem and environment. **/
+    ~CplexBackend();
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+	/** Returns the name of the backend. **/
+    std::string getName() const { return "CPLEX"; }
+
+	/** Returns true if CPLEX has proven the obtained solution to be optimal. **/
+    bool isOptimal() const { return (status == CPXMIP_OPTIMAL || status == CPXMIP_OPTIMAL_TOL); }
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+	/** Builds the MIP, solves it and returns true if an optimal solution has been found. **/
+    bool solve();
+
+	/** Fills the columns (objective, bounds and names) and the slice index of every demand. **/
+    void buildColumns();
+
+	/** Fills the rows of every demand with index in [first, ..., last) by steps of step. @warning Columns of every demand must have been built. **/
+    void buildRows(int first, int last, int step);
+
+	/** Assembles every column and row of the model, using nbThreads threads for the rows. **/
+    void buildModel();
+
+	/** Loads the assembled arrays into CPLEX with one CPXaddcols and one CPXaddrows call. **/
+    void loadModel();
+
+	/** Fills the source, flow conservation, target and length rows of the d-th demand. @param d The demand index. @param rows The block to be filled. **/
+    void buildRoutingRows(int d, RowBlock &rows);
+
+	/** Fills the non-overlapping rows between the d-th demand and every other demand. @param d The demand index. @param rows The block to be filled. **/
+    void buildNonOverlappingRows(int d, RowBlock &rows);
+
+	/** Fills the row ordering the d-th demand after the previous identical demand, if any. @param d The demand index. @param rows The block to be filled. **/
+    void buildSymmetryBreakingRows(int d, RowBlock &rows);
+
+	/** Aborts the program if a CPLEX routine has failed. @param error The code returned by the routine. @param routine The name of the routine. **/
+    void checkError(int error, std::string routine);
+};
+
+#endif
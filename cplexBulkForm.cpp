@@ -0,0 +1,8 @@
+#include "cplexBulkForm.h"
+
+/* Constructor. Builds the Online RSA mixed-integer program in bulk and solves it using CPLEX. */
+CplexBulkForm::CplexBulkForm(const Instance &inst) : Solver(inst), backend(inst.getInput().getNbThreads(), inst.getInput().getModelNames()), isSolved(false){
+    std::cout << "--- CPLEX (bulk loading) has been chosen ---" << std::endl;
+    isSolved = solve(backend);
+}
+
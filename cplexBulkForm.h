@@ -0,0 +1,35 @@
+#ifndef __cplexBulkForm__h
+#define __cplexBulkForm__h
+
+#include "solver.h"
+#include "cplexBackend.h"
+
+/*********************************************************************************************
+* This class implements and solves the Online Routing and Spectrum Allocation MIP using the
+* CPLEX Callable Library. Instead of creating Concert objects one at a time, the model is
+* written into the backend-neutral routing model and handed to CplexBackend, which assembles
+* every row in contiguous arrays (possibly by several threads) and loads them with a single
+* CPXaddcols and a single CPXaddrows call. The model is equivalent to the one built by
+* CplexForm.
+*********************************************************************************************/
+class CplexBulkForm : public Solver{
+
+private:
+	CplexBackend backend;				/**< The backend assembling, loading and solving the model. **/
+	bool isSolved;						/**< True if the backend has found an optimal solution. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Builds the Online RSA mixed-integer program in bulk and solves it using CPLEX. @param instance The instance to be solved. **/
+	CplexBulkForm(const Instance &instance);
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+	/** Returns true if CPLEX has proven the obtained solution to be optimal. **/
+	bool isOptimal() const { return isSolved && backend.isOptimal(); }
+};
+
+#endif
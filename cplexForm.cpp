@@ -4,7 +4,18 @@
 int CplexForm::count = 0;
 
 /* Constructor. Builds the Online RSA mixed-integer program and solves it using CPLEX. */
-CplexForm::CplexForm(const Instance &inst) : Solver(inst), model(env), cplex(model), x(env, getNbDemandsToBeRouted()){
+CplexForm::CplexForm(const Instance &inst) : Solver(inst), model(env), cplex(model), x(env, getNbDemandsToBeRouted()), nbLengthCoverCuts(0){
+    buildAndSolve(IloInfinity);
+}
+
+/* Constructor. Erases the arcs fixed to zero by a dual method before building the MIP, and solves it with an upper cutoff. */
+CplexForm::CplexForm(const Instance &inst, const std::vector< std::set<ArcKey> > &fixedArcs, double cutoff) : Solver(inst), model(env), cplex(model), x(env, getNbDemandsToBeRouted()), nbLengthCoverCuts(0){
+    eraseFixedArcs(fixedArcs);
+    buildAndSolve(cutoff);
+}
+
+/* Builds the MIP on the arcs of each graph and solves it. Solutions whose cost exceeds cutoff are discarded. */
+void CplexForm::buildAndSolve(double cutoff){
     std::cout << "--- CPLEX has been chosen ---" << std::endl;
     count++;
     /************************************************/
@@ -36,6 +47,9 @@ CplexForm::CplexForm(const Instance &inst) : Solver(inst), model(env), cplex(mod
 
     this->setNonOverlappingConstraints(x, model);    
     std::cout << "Non-Overlapping constraints have been defined..." << std::endl;
+
+    this->setSymmetryBreakingConstraints(x, model);
+    std::cout << "Symmetry-breaking constraints have been defined..." << std::endl;
     
 	/************************************************/
 	/*		    EXPORT LINEAR PROGRAM TO .LP		*/
@@ -48,6 +62,12 @@ CplexForm::CplexForm(const Instance &inst) : Solver(inst), model(env), cplex(mod
 	/*             DEFINE CPLEX PARAMETERS   		*/
 	/************************************************/
     cplex.setParam(IloCplex::Param::MIP::Display, 2);
+    if (cutoff < IloInfinity){
+        cplex.setParam(IloCplex::Param::MIP::Tolerances::UpperCutoff, cutoff);
+    }
+    if (getInstance().getInput().getLengthCoverCuts()){
+        setLengthCoverCuts();
+    }
     std::cout << "CPLEX parameters have been defined..." << std::endl;
 
 	/************************************************/
@@ -70,6 +90,7 @@ CplexForm::CplexForm(const Instance &inst) : Solver(inst), model(env), cplex(mod
         displayOnPath();
         
         std::cout << "Number of cplex cuts: " << getNbCutsFromCplex() << std::endl;
+        std::cout << "Number of length cover cuts: " << getNbLengthCoverCuts() << std::endl;
     }
     else{
         std::cout << "Could not find a path!" << std::endl;
@@ -102,6 +123,21 @@ IloInt CplexForm::getNbCutsFromCplex(){
     return cutsFromCplex;
 }
 
+/* Attaches to CPLEX a user cut callback separating cover inequalities from the length constraint of each demand. */
+void CplexForm::setLengthCoverCuts(){
+    std::vector< std::vector<double> > length(getNbDemandsToBeRouted());
+    std::vector<double> maxLength(getNbDemandsToBeRouted());
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        length[d].resize(countArcs(*vecGraph[d]), 0.0);
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            length[d][getArcIndex(a, d)] = getArcLength(a, d);
+        }
+        maxLength[d] = getToBeRouted_k(d).getMaxLength();
+    }
+    cplex.use(new (env) LengthCoverCallback(env, x, length, maxLength, &nbLengthCoverCuts));
+    std::cout << "Length cover cuts have been activated..." << std::endl;
+}
+
 /* Recovers the obtained MIP solution and builds a path for each demand on its associated graph from RSA. */
 void CplexForm::updatePath(){
     for(int d = 0; d < getNbDemandsToBeRouted(); d++){
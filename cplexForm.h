@@ -2,6 +2,7 @@
 #define __cplexForm__h
 
 #include "solver.h"
+#include "lengthCoverCallback.h"
 
 typedef IloArray<IloNumVarArray> IloNumVarMatrix;
 
@@ -17,6 +18,7 @@ private:
     IloCplex cplex;		/**< The CPLEX engine. **/
     IloNumVarMatrix x;	/**< The matrix of variables used in the MIP. x[i][j]=1 if the i-th demand to be routed is assigned to the arc from id j. **/
     static int count;	/**< Counts how many times CPLEX is called. **/
+    std::atomic<int> nbLengthCoverCuts;	/**< Counts the length cover cuts added by the user cut callback. **/
 
 public:
 
@@ -26,6 +28,9 @@ public:
 	/** Constructor. Builds the Online RSA mixed-integer program and solves it using CPLEX.  @param instance The instance to be solved. **/
     CplexForm(const Instance &instance);
 
+	/** Constructor. Builds the MIP only on the arcs that are not fixed to zero and solves it using CPLEX, discarding solutions whose cost exceeds cutoff. @param instance The instance to be solved. @param fixedArcs The keys of the arcs fixed to zero on each graph. @param cutoff The upper cutoff (usually a known upper bound plus a tolerance). **/
+    CplexForm(const Instance &instance, const std::vector< std::set<ArcKey> > &fixedArcs, double cutoff);
+
 	/****************************************************************************************/
 	/*										Getters											*/
 	/****************************************************************************************/
@@ -35,9 +40,18 @@ public:
 	/** Returns the total number of CPLEX default cuts applied during optimization. **/
 	IloInt getNbCutsFromCplex();
 
+	/** Returns the number of length cover cuts added by the user cut callback. **/
+	int getNbLengthCoverCuts() const { return nbLengthCoverCuts; }
+
 	/****************************************************************************************/
 	/*										Methods											*/
 	/****************************************************************************************/
+	/** Builds the MIP on the arcs of each graph and solves it. @param cutoff Solutions whose cost exceeds cutoff are discarded (IloInfinity for none). **/
+    void buildAndSolve(double cutoff);
+
+	/** Attaches to CPLEX a user cut callback separating cover inequalities from the length constraint of each demand. **/
+    void setLengthCoverCuts();
+
 	/** Recovers the obtained MIP solution and builds a path for each demand on its associated graph from RSA. **/
     void updatePath();
 
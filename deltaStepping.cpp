@@ -0,0 +1,208 @@
+#include "deltaStepping.h"
+
+#include <cmath>
+#include <algorithm>
+
+/* Constructor. Copies the adjacency of a graph in a compressed array. */
+DeltaStepping::DeltaStepping(const ListDigraph &g, int nbThreads) : nbThreads(std::max(1, nbThreads)), delta(1.0), nbQueued(0),
+        phaseId(0), nbBusy(0), isStopping(false), phaseFrontier(NULL), phaseWeight(NULL), phaseLight(true) {
+    int nbNodes = g.maxNodeId() + 1;
+    firstOut.assign(nbNodes + 1, 0);
+    arcTail.assign(g.maxArcId() + 1, -1);
+    for (ListDigraph::ArcIt a(g); a != INVALID; ++a){
+        firstOut[ListDigraph::id(g.source(a)) + 1]++;
+    }
+    for (int v = 0; v < nbNodes; v++){
+        firstOut[v + 1] += firstOut[v];
+    }
+    arcHead.resize(firstOut[nbNodes]);
+    arcId.resize(firstOut[nbNodes]);
+    std::vector<int> position(firstOut.begin(), firstOut.end() - 1);
+    for (ListDigraph::ArcIt a(g); a != INVALID; ++a){
+        int tail = ListDigraph::id(g.source(a));
+        arcHead[position[tail]] = ListDigraph::id(g.target(a));
+        arcId[position[tail]] = ListDigraph::id(a);
+        arcTail[ListDigraph::id(a)] = tail;
+        position[tail]++;
+    }
+    requests.resize(this->nbThreads);
+}
+
+/* Sets delta to the mean positive arc weight, or more if the largest weight would need more than MAX_NB_BUCKETS buckets. */
+void DeltaStepping::chooseDelta(const std::vector<double> &weight){
+    double sum = 0.0;
+    double maxWeight = 0.0;
+    int nb = 0;
+    for (unsigned int i = 0; i < arcId.size(); i++){
+        double w = weight[arcId[i]];
+        if (w > 0.0 && w < std::numeric_limits<double>::infinity()){
+            sum += w;
+            maxWeight = std::max(maxWeight, w);
+            nb++;
+        }
+    }
+    delta = (nb > 0) ? std::max(sum/nb, maxWeight/MAX_NB_BUCKETS) : 1.0;
+    /* While bucket i is settled, every tentative distance is below (i+1)*delta + maxWeight: buckets i to i + maxWeight/delta + 1 are enough. */
+    buckets.assign((int)std::floor(maxWeight/delta) + 2, std::vector<int>());
+    nbQueued = 0;
+}
+
+/* Stores a node id in the circular bucket of its tentative distance. */
+void DeltaStepping::enqueue(int v){
+    buckets[(long long)std::floor(distance[v]/delta) % buckets.size()].push_back(v);
+    nbQueued++;
+}
+
+/* Collects the requests of the light (or heavy) arcs leaving the frontier nodes at positions [first, last). */
+void DeltaStepping::collect(const std::vector<int> &frontier, int first, int last, const std::vector<double> &weight, bool light, std::vector<Request> &out) const {
+    out.clear();
+    for (int k = first; k < last; k++){
+        int v = frontier[k];
+        for (int i = firstOut[v]; i < firstOut[v + 1]; i++){
+            double w = weight[arcId[i]];
+            if ((w <= delta) == light){
+                double candidate = distance[v] + w;
+                if (candidate < distance[arcHead[i]]){
+                    Request request = {arcHead[i], arcId[i], candidate};
+                    out.push_back(request);
+                }
+            }
+        }
+    }
+}
+
+/* Collects the requests of the t-th of nbThreads equal parts of the frontier of the current phase. */
+void DeltaStepping::collectPart(int t){
+    int size = phaseFrontier->size();
+    int chunk = (size + nbThreads - 1)/nbThreads;
+    int first = std::min(size, t*chunk);
+    int last = std::min(size, first + chunk);
+    collect(*phaseFrontier, first, last, *phaseWeight, phaseLight, requests[t]);
+}
+
+/* Waits for each parallel phase of the run, collects the requests of part t and reports to the calling thread, until the run ends. */
+void DeltaStepping::helpLoop(int t){
+    int lastPhase = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true){
+        phaseStarted.wait(lock, [&]{ return isStopping || phaseId != lastPhase; });
+        if (isStopping){
+            return;
+        }
+        lastPhase = phaseId;
+        lock.unlock();
+        collectPart(t);
+        lock.lock();
+        nbBusy--;
+        if (nbBusy == 0){
+            phaseDone.notify_one();
+        }
+    }
+}
+
+/* Joins the helpers, if any. */
+void DeltaStepping::stopHelpers(){
+    if (helpers.empty()){
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopping = true;
+    }
+    phaseStarted.notify_all();
+    for (unsigned int t = 0; t < helpers.size(); t++){
+        helpers[t].join();
+    }
+    helpers.clear();
+}
+
+/* Relaxes the light (or heavy) arcs leaving the frontier. Distances are only read while requests are collected, and only written once every thread is done. */
+void DeltaStepping::relax(const std::vector<int> &frontier, const std::vector<double> &weight, bool light){
+    int nbWorkers = 1;
+    if ((int)frontier.size() >= MIN_PARALLEL_FRONTIER){
+        nbWorkers = nbThreads;
+    }
+    if (nbWorkers <= 1){
+        collect(frontier, 0, frontier.size(), weight, light, requests[0]);
+    }
+    else{
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (helpers.empty()){
+                isStopping = false;
+                phaseId = 0;
+                for (int t = 1; t < nbThreads; t++){
+                    helpers.emplace_back(&DeltaStepping::helpLoop, this, t);
+                }
+            }
+            phaseFrontier = &frontier;
+            phaseWeight = &weight;
+            phaseLight = light;
+            nbBusy = nbThreads - 1;
+            phaseId++;
+        }
+        phaseStarted.notify_all();
+        collectPart(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        phaseDone.wait(lock, [&]{ return nbBusy == 0; });
+    }
+    for (int t = 0; t < nbWorkers; t++){
+        for (unsigned int k = 0; k < requests[t].size(); k++){
+            const Request &request = requests[t][k];
+            if (request.dist < distance[request.head]){
+                distance[request.head] = request.dist;
+                predArcId[request.head] = request.arc;
+                enqueue(request.head);
+            }
+        }
+        requests[t].clear();
+    }
+}
+
+/* Computes the shortest paths from s by delta-stepping, stopping once the distance of t is exact. The helpers started during the run are joined at its end. */
+void DeltaStepping::run(const std::vector<double> &weight, const ListDigraph::Node &s, const ListDigraph::Node &t){
+    const double INF = std::numeric_limits<double>::infinity();
+    int nbNodes = firstOut.size() - 1;
+    chooseDelta(weight);
+    distance.assign(nbNodes, INF);
+    predArcId.assign(nbNodes, -1);
+    distance[ListDigraph::id(s)] = 0.0;
+    enqueue(ListDigraph::id(s));
+    int target = ListDigraph::id(t);
+
+    /* phaseMark[v] is the last phase in which v was in the frontier, settledMark[v] the last bucket in which v was settled. */
+    std::vector<int> phaseMark(nbNodes, -1);
+    std::vector<long long> settledMark(nbNodes, -1);
+    std::vector<int> frontier;
+    std::vector<int> settled;
+    int phase = 0;
+    for (long long current = 0; nbQueued > 0; current++){
+        /* Every node left has a distance of at least current*delta: the target's distance is exact. */
+        if (distance[target] <= current*delta){
+            break;
+        }
+        std::vector<int> &slot = buckets[current % buckets.size()];
+        settled.clear();
+        while (!slot.empty()){
+            frontier.clear();
+            std::vector<int> bucket;
+            bucket.swap(slot);
+            nbQueued -= bucket.size();
+            for (unsigned int k = 0; k < bucket.size(); k++){
+                int v = bucket[k];
+                if ((long long)std::floor(distance[v]/delta) == current && phaseMark[v] != phase){
+                    phaseMark[v] = phase;
+                    frontier.push_back(v);
+                    if (settledMark[v] != current){
+                        settledMark[v] = current;
+                        settled.push_back(v);
+                    }
+                }
+            }
+            relax(frontier, weight, true);
+            phase++;
+        }
+        relax(settled, weight, false);
+    }
+    stopHelpers();
+}
@@ -0,0 +1,126 @@
+#ifndef __deltaStepping__h
+#define __deltaStepping__h
+
+#include <vector>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <lemon/list_graph.h>
+
+using namespace lemon;
+
+/*********************************************************************************************
+* This class computes shortest paths from a source on a fixed ListDigraph with the parallel
+* delta-stepping algorithm of Meyer and Sanders. Nodes are kept in buckets of width delta by
+* tentative distance. The nodes of the current bucket are settled in phases: in each phase,
+* the light arcs (weight <= delta) leaving the frontier are relaxed in parallel, each thread
+* collecting its own requests, and the requests are then applied. Heavy arcs are relaxed once
+* per bucket. The graph is copied in a compressed adjacency array at construction, so the
+* graph must not change afterwards; weights are given to each run, indexed by arc id.
+* Buckets are reused circularly: tentative distances are never more than the largest weight
+* beyond the current bucket, so at most MAX_NB_BUCKETS + 2 buckets are kept.
+* \note Frontiers of less than MIN_PARALLEL_FRONTIER nodes are relaxed sequentially, since
+* smaller phases are faster that way. The helper threads are started at the first larger
+* frontier of a run, wait on a condition variable between phases and are joined at the end
+* of the run.
+*********************************************************************************************/
+class DeltaStepping {
+
+private:
+    const int MIN_PARALLEL_FRONTIER = 1024;
+    const int MAX_NB_BUCKETS = 1 << 16;
+
+    /** A relaxation request: node head may be reached at distance dist through arc. **/
+    struct Request {
+        int head;       /**< The node id. **/
+        int arc;        /**< The arc id. **/
+        double dist;    /**< The tentative distance. **/
+    };
+
+    int nbThreads;                          /**< The number of threads used for relaxing arcs. **/
+    std::vector<int> firstOut;              /**< The arcs leaving node id v are at positions [firstOut[v], firstOut[v+1]) of the arrays below. **/
+    std::vector<int> arcHead;               /**< The node id of the head of each arc. **/
+    std::vector<int> arcId;                 /**< The LEMON id of each arc. **/
+    std::vector<int> arcTail;               /**< arcTail[id] is the node id of the tail of the arc with LEMON id id. **/
+    double delta;                           /**< The bucket width of the last run. **/
+    std::vector<double> distance;           /**< The tentative distance of each node id, +Infinity if not reached. **/
+    std::vector<int> predArcId;             /**< The id of the arc reaching each node on its shortest path, -1 if none. **/
+    std::vector< std::vector<int> > buckets; /**< buckets[i % buckets.size()] stores the node ids whose tentative distance is in [i*delta, (i+1)*delta), possibly twice or outdated. **/
+    int nbQueued;                           /**< The number of node ids stored in the buckets. **/
+    std::vector< std::vector<Request> > requests;   /**< requests[t] stores the requests collected by thread t. **/
+
+    std::vector<std::thread> helpers;       /**< The threads collecting requests with the calling thread, running until the end of the run. **/
+    std::mutex mutex;                       /**< Guards the fields below. **/
+    std::condition_variable phaseStarted;   /**< Wakes the helpers when a phase starts or the run ends. **/
+    std::condition_variable phaseDone;      /**< Wakes the calling thread when the last helper is done. **/
+    int phaseId;                            /**< The number of parallel phases started in the run. **/
+    int nbBusy;                             /**< The number of helpers still collecting requests in the current phase. **/
+    bool isStopping;                        /**< True once the run asks the helpers to return. **/
+    const std::vector<int> *phaseFrontier;  /**< The frontier of the current phase. **/
+    const std::vector<double> *phaseWeight; /**< The arc weights of the current phase. **/
+    bool phaseLight;                        /**< True if the current phase relaxes light arcs. **/
+
+    /** Sets delta from the weight distribution: the mean positive arc weight, so that a bucket holds about one arc of each path, but at least the largest weight over MAX_NB_BUCKETS. Sizes the circular buckets accordingly. @param weight The arc weights. **/
+    void chooseDelta(const std::vector<double> &weight);
+
+    /** Stores a node id in the bucket of its tentative distance. @param v The node id. **/
+    void enqueue(int v);
+
+    /** Collects the requests of the t-th part of the frontier of the current phase. @param t The part, 0 for the calling thread. **/
+    void collectPart(int t);
+
+    /** Waits for the phases of a run and collects the requests of its part in each of them. @param t The part of the helper. **/
+    void helpLoop(int t);
+
+    /** Joins the helpers, if any. **/
+    void stopHelpers();
+
+    /** Collects the requests of the arcs leaving a part of the frontier whose weight is light (or heavy). @param frontier The node ids. @param first The first position of the part. @param last The position after the part. @param weight The arc weights. @param light True for light arcs, false for heavy ones. @param out Receives the requests. **/
+    void collect(const std::vector<int> &frontier, int first, int last, const std::vector<double> &weight, bool light, std::vector<Request> &out) const;
+
+    /** Relaxes the light (or heavy) arcs leaving the frontier, in parallel if it is large enough, starting the helpers if needed. @param frontier The node ids. @param weight The arc weights. @param light True for light arcs, false for heavy ones. **/
+    void relax(const std::vector<int> &frontier, const std::vector<double> &weight, bool light);
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+    /** Constructor. Copies the adjacency of a graph. @param g The graph. @param nbThreads The number of threads used for relaxing arcs. **/
+    DeltaStepping(const ListDigraph &g, int nbThreads);
+
+    /** Destructor. Joins the helpers, if any. **/
+    ~DeltaStepping() { stopHelpers(); }
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+    /** Returns the number of arcs of the graph. **/
+    int getNbArcs() const { return (int)arcHead.size(); }
+
+    /** Returns the number of threads used for relaxing arcs. **/
+    int getNbThreads() const { return nbThreads; }
+
+    /** Returns the bucket width of the last run. **/
+    double getDelta() const { return delta; }
+
+    /** Returns true if a node has been reached by the last run. @param v The node. **/
+    bool reached(const ListDigraph::Node &v) const { return distance[ListDigraph::id(v)] < std::numeric_limits<double>::infinity(); }
+
+    /** Returns the distance of a node found by the last run. @param v The node. **/
+    double dist(const ListDigraph::Node &v) const { return distance[ListDigraph::id(v)]; }
+
+    /** Returns the last arc of the shortest path to a node found by the last run. @param v The node. **/
+    ListDigraph::Arc predArc(const ListDigraph::Node &v) const { return ListDigraph::arcFromId(predArcId[ListDigraph::id(v)]); }
+
+    /** Returns the node before a node on the shortest path found by the last run. @param v The node. **/
+    ListDigraph::Node predNode(const ListDigraph::Node &v) const { return ListDigraph::nodeFromId(arcTail[predArcId[ListDigraph::id(v)]]); }
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+    /** Computes the shortest paths from s, stopping once the distance of t is exact. @param weight The non-negative arc weights, indexed by arc id. @param s The source. @param t The target. **/
+    void run(const std::vector<double> &weight, const ListDigraph::Node &s, const ListDigraph::Node &t);
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "feasibilityGate.h"
+
+#include <queue>
+#include <limits>
+#include <algorithm>
+
+/* Constructor. Decides the verdict for the demands of the next optimization. */
+FeasibilityGate::FeasibilityGate(const Instance &inst, PathCache *pathCache) : instance(inst), toBeRouted(inst.getNextDemands()),
+        cache(pathCache), verdict(VERDICT_OPTIMIZER) {
+
+    incident.assign(instance.getNbNodes(), std::vector< std::pair<int, int> >());
+    isUsed.assign(instance.getNbEdges(), std::vector<bool>());
+    for (int i = 0; i < instance.getNbEdges(); i++){
+        PhysicalLink link = instance.getPhysicalLinkFromId(i);
+        incident[link.getSource()].push_back(std::make_pair(i, link.getTarget()));
+        incident[link.getTarget()].push_back(std::make_pair(i, link.getSource()));
+        for (int s = 0; s < link.getNbSlices(); s++){
+            isUsed[i].push_back(link.getSlice_i(s).isUsed());
+        }
+    }
+
+    for (unsigned int d = 0; d < toBeRouted.size(); d++){
+        if (isRoutableAlone(toBeRouted[d]) == false){
+            std::cout << "> Feasibility gate: demand " << toBeRouted[d].getId() + 1 << " cannot be routed." << std::endl;
+            verdict = VERDICT_INFEASIBLE;
+            return;
+        }
+    }
+
+    Input::ObjectiveMetric obj = instance.getInput().getChosenObj();
+    if (obj != Input::OBJECTIVE_METRIC_1 && obj != Input::OBJECTIVE_METRIC_2 && obj != Input::OBJECTIVE_METRIC_4){
+        return;
+    }
+    cache->setTopology(instance);
+    vecPathLinks.resize(toBeRouted.size());
+    vecPathSlice.assign(toBeRouted.size(), -1);
+    for (unsigned int d = 0; d < toBeRouted.size(); d++){
+        if (assignAtLowerBound(d) == false){
+            return;
+        }
+    }
+    std::cout << "> Feasibility gate: every demand is routed at its lower bound." << std::endl;
+    verdict = VERDICT_TRIVIAL;
+}
+
+/* Returns true if a demand can be routed when it is the only one: some window of slices must be free on a path within the maximal length. */
+bool FeasibilityGate::isRoutableAlone(const Demand &demand) const {
+    if (instance.getShortestDistance(demand.getSource(), demand.getTarget()) > demand.getMaxLength()){
+        return false;
+    }
+    int nbSlices = 0;
+    for (unsigned int i = 0; i < isUsed.size(); i++){
+        nbSlices = std::max(nbSlices, (int)isUsed[i].size());
+    }
+    for (int s = demand.getLoad() - 1; s < nbSlices; s++){
+        if (getWindowDistance(demand.getSource(), demand.getTarget(), s, demand.getLoad(), demand.getMaxLength()) <= demand.getMaxLength()){
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Returns the length of the shortest path from source to target on the links where a window of slices is free, with Dijkstra's algorithm stopped beyond the maximal length. */
+double FeasibilityGate::getWindowDistance(int source, int target, int slice, int load, double maxLength) const {
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> dist(instance.getNbNodes(), INF);
+    typedef std::pair<double, int> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    dist[source] = 0.0;
+    heap.push(Entry(0.0, source));
+    while (!heap.empty()){
+        double nodeDist = heap.top().first;
+        int u = heap.top().second;
+        heap.pop();
+        if (nodeDist > dist[u]){
+            continue;
+        }
+        if (u == target || nodeDist > maxLength){
+            break;
+        }
+        for (unsigned int k = 0; k < incident[u].size(); k++){
+            int link = incident[u][k].first;
+            int v = incident[u][k].second;
+            double candidate = nodeDist + instance.getPhysicalLinkFromId(link).getLength();
+            if (candidate < dist[v] && isWindowFree(link, slice, load)){
+                dist[v] = candidate;
+                heap.push(Entry(candidate, v));
+            }
+        }
+    }
+    return dist[target];
+}
+
+/* Returns true if the window of load slices ending at slice is free on a link. */
+bool FeasibilityGate::isWindowFree(int link, int slice, int load) const {
+    if (slice - load + 1 < 0 || slice >= (int)isUsed[link].size()){
+        return false;
+    }
+    for (int s = slice - load + 1; s <= slice; s++){
+        if (isUsed[link][s]){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Returns true if the window of load slices ending at slice is free on every link of a path. */
+bool FeasibilityGate::isWindowFree(const std::vector<int> &links, int slice, int load) const {
+    for (unsigned int k = 0; k < links.size(); k++){
+        if (isWindowFree(links[k], slice, load) == false){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Assigns the d-th demand to the first candidate path reaching its lower bound on which a window is free: the shortest length for metric 4, the fewest hops for metric 2, and also the lowest window for metric 1. */
+bool FeasibilityGate::assignAtLowerBound(int d){
+    const Demand &demand = toBeRouted[d];
+    const double EPS = 1e-9;
+    double minLength = instance.getShortestDistance(demand.getSource(), demand.getTarget());
+    int minNbHops = instance.getMinNbHops(demand.getSource(), demand.getTarget());
+    Input::ObjectiveMetric obj = instance.getInput().getChosenObj();
+    const std::vector<PathCache::CachedPath> &paths = cache->getPaths(demand.getSource(), demand.getTarget());
+    for (unsigned int p = 0; p < paths.size() && paths[p].length <= demand.getMaxLength(); p++){
+        if (obj == Input::OBJECTIVE_METRIC_4 && paths[p].length > minLength + EPS*std::max(1.0, minLength)){
+            break;
+        }
+        if (obj != Input::OBJECTIVE_METRIC_4 && paths[p].nbHops > minNbHops){
+            continue;
+        }
+        int lastSlice = std::numeric_limits<int>::max();
+        for (unsigned int k = 0; k < paths[p].links.size(); k++){
+            lastSlice = std::min(lastSlice, (int)isUsed[paths[p].links[k]].size() - 1);
+        }
+        if (obj == Input::OBJECTIVE_METRIC_1){
+            lastSlice = std::min(lastSlice, demand.getLoad() - 1);
+        }
+        for (int s = demand.getLoad() - 1; s <= lastSlice; s++){
+            if (isWindowFree(paths[p].links, s, demand.getLoad())){
+                vecPathLinks[d] = paths[p].links;
+                vecPathSlice[d] = s;
+                for (unsigned int k = 0; k < paths[p].links.size(); k++){
+                    for (int pos = s - demand.getLoad() + 1; pos <= s; pos++){
+                        isUsed[paths[p].links[k]][pos] = true;
+                    }
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Updates the instance with the windows assigned to every demand. */
+void FeasibilityGate::updateInstance(Instance &i){
+    for (unsigned int d = 0; d < toBeRouted.size(); d++){
+        Demand demand = i.getDemandFromIndex(toBeRouted[d].getId());
+        for (unsigned int k = 0; k < vecPathLinks[d].size(); k++){
+            i.assignSlicesOfLink(vecPathLinks[d][k], vecPathSlice[d], demand);
+        }
+    }
+    i.displaySlices();
+}
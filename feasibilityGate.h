@@ -0,0 +1,71 @@
+#ifndef __feasibilityGate__h
+#define __feasibilityGate__h
+
+#include "Instance.h"
+#include "pathCache.h"
+
+/*********************************************************************************************
+* This class decides, before any extended graph is built, whether the demands of the next
+* optimization need the full optimizer. The demands are provably infeasible if one of them
+* cannot be routed even alone: for each window of slices, the shortest path on the links where
+* the window is free is longer than the maximal length. The demands are trivially routable if,
+* for a metric whose cost only depends on each demand's path and slice (metrics 1, 2 and 4),
+* every demand can be assigned in turn a candidate path and window of the path cache reaching
+* its own lower bound: the solution found is then optimal. Otherwise, the optimizer is needed.
+*********************************************************************************************/
+class FeasibilityGate {
+
+public:
+    /** The verdicts of the gate. **/
+    enum Verdict {
+        VERDICT_INFEASIBLE = 0,     /**< Some demand cannot be routed. **/
+        VERDICT_TRIVIAL = 1,        /**< An optimal solution has been found without optimizer. **/
+        VERDICT_OPTIMIZER = 2       /**< The full optimizer is needed. **/
+    };
+
+private:
+    const Instance &instance;                           /**< The instance describing the current mapping. **/
+    std::vector<Demand> toBeRouted;                     /**< The demands to be routed in this optimization. **/
+    PathCache *cache;                                   /**< The cache of the k shortest paths of each pair of nodes. **/
+    std::vector< std::vector< std::pair<int, int> > > incident; /**< incident[u] stores the pairs (link id, other endpoint) of the links incident to node u. **/
+    std::vector< std::vector<bool> > isUsed;            /**< isUsed[link][slice] is true if the slice is taken in the instance or by a demand assigned earlier. **/
+    std::vector< std::vector<int> > vecPathLinks;       /**< vecPathLinks[d] stores the links of the path assigned to the d-th demand. **/
+    std::vector<int> vecPathSlice;                      /**< vecPathSlice[d] is the last slice of the window assigned to the d-th demand. **/
+    Verdict verdict;                                    /**< The verdict of the gate. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+    /** Constructor. Decides the verdict for the demands of the next optimization. @param inst The instance. @param pathCache The cache of shortest paths kept across optimizations. **/
+    FeasibilityGate(const Instance &inst, PathCache *pathCache);
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+    /** Returns the verdict of the gate. **/
+    Verdict getVerdict() const { return verdict; }
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+    /** Returns true if a demand can be routed when it is the only one. @param demand The demand. **/
+    bool isRoutableAlone(const Demand &demand) const;
+
+    /** Returns the length of the shortest path from source to target on the links where a window of slices is free, or a value above the maximal length if there is none within it. @param source The source node. @param target The target node. @param slice The last slice of the window. @param load The number of slices of the window. @param maxLength The maximal length. **/
+    double getWindowDistance(int source, int target, int slice, int load, double maxLength) const;
+
+    /** Returns true if the window of load slices ending at slice is free on a link. @param link The link. @param slice The last slice of the window. @param load The number of slices of the window. **/
+    bool isWindowFree(int link, int slice, int load) const;
+
+    /** Returns true if the window of load slices ending at slice is free on every link of a path. @param links The links of the path. @param slice The last slice of the window. @param load The number of slices of the window. **/
+    bool isWindowFree(const std::vector<int> &links, int slice, int load) const;
+
+    /** Assigns the d-th demand to a candidate path and window reaching its lower bound for the chosen metric, and returns false if there is none. @param d The demand index. **/
+    bool assignAtLowerBound(int d);
+
+    /** Updates the instance with the windows assigned to every demand. Only valid if the verdict is VERDICT_TRIVIAL. @param i The instance to be updated. **/
+    void updateInstance(Instance &i);
+};
+
+#endif
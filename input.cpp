@@ -8,16 +8,25 @@ Input::Input(std::string parameterFile) : PARAMETER_FILE(parameterFile){
     onlineDemandFolder = getParameterValue("onlineDemandFolder=");
     nbDemandsAtOnce = std::stoi(getParameterValue("nbDemandsAtOnce="));
     outputPath = getParameterValue("outputPath=");
+    pathCacheFolder = getParameterValue("pathCacheFolder=");
     nbSlicesInOutputFile = std::stoi(getParameterValue("nbSlicesInOutputFile="));
     
     chosenMethod = (Method) std::stoi(getParameterValue("method="));
     chosenPreprLvl = (PreprocessingLevel) std::stoi(getParameterValue("preprocessingLevel="));
     chosenObj = to_ObjectiveMetric(getParameterValue("obj="));
+    nbThreads = std::stoi(getParameterValue("nbThreads="));
+    modelNames = (bool) std::stoi(getParameterValue("modelNames="));
+    lengthCoverCuts = (bool) std::stoi(getParameterValue("lengthCoverCuts="));
 
     lagrangianMultiplier_zero = std::stod(getParameterValue("lagrangianMultiplier_zero="));
     lagrangianLambda_zero = std::stod(getParameterValue("lagrangianLambda_zero="));
     nbIterationsWithoutImprovement = std::stoi(getParameterValue("nbIterationsWithoutImprovement="));
     maxNbIterations = std::stoi(getParameterValue("maxNbIterations="));
+    maxNbPricingIterations = std::stoi(getParameterValue("maxNbPricingIterations="));
+    chosenMultiplierUpdate = (MultiplierUpdate) std::stoi(getParameterValue("multiplierUpdate="));
+    targetGap = std::stod(getParameterValue("targetGap="));
+    nbSubgradientStarts = std::stoi(getParameterValue("nbSubgradientStarts="));
+    nbCandidatePaths = std::stoi(getParameterValue("nbCandidatePaths="));
 
     if (!onlineDemandFolder.empty()) {
         populateOnlineDemandFiles();
@@ -34,15 +43,25 @@ Input::Input(const Input &i) : PARAMETER_FILE(i.getParameterFile()){
     vecOnlineDemandFile = i.getOnlineDemandFiles();
     nbDemandsAtOnce = i.getNbDemandsAtOnce();
     outputPath = i.getOutputPath();
+    pathCacheFolder = i.getPathCacheFolder();
     nbSlicesInOutputFile = i.getnbSlicesInOutputFile();
 
     chosenMethod = i.getChosenMethod();
     chosenPreprLvl = i.getChosenPreprLvl();
     chosenObj = i.getChosenObj();
+    nbThreads = i.getNbThreads();
+    modelNames = i.getModelNames();
+    lengthCoverCuts = i.getLengthCoverCuts();
 
     lagrangianMultiplier_zero = i.getInitialLagrangianMultiplier();
     lagrangianLambda_zero = i.getInitialLagrangianLambda();
+    nbIterationsWithoutImprovement = i.getNbIterationsWithoutImprovement();
     maxNbIterations = i.getMaxNbIterations();
+    maxNbPricingIterations = i.getMaxNbPricingIterations();
+    chosenMultiplierUpdate = i.getChosenMultiplierUpdate();
+    targetGap = i.getTargetGap();
+    nbSubgradientStarts = i.getNbSubgradientStarts();
+    nbCandidatePaths = i.getNbCandidatePaths();
 }
 
 /* Returns the path to the file containing all the parameters. */
@@ -18,7 +18,24 @@ public:
 	/** Enumerates the possible methods to be applied for solving the Online Routing and Spectrum Allocation problem.**/
 	enum Method {						
 		METHOD_CPLEX = 0,  /**< Solve it through a MIP using CPLEX. **/
-		METHOD_SUBGRADIENT = 1 /**<  Solve it using the subgradient method.**/
+		METHOD_SUBGRADIENT = 1, /**<  Solve it using the subgradient method.**/
+		METHOD_CPLEX_BULK = 2,	/**< Solve it through a MIP using CPLEX, loading the whole model at once through the Callable Library. **/
+		METHOD_CPLEX_COMPACT = 3,	/**< Solve it through a compact edge/slot MIP using CPLEX. **/
+		METHOD_COLUMN_GENERATION = 4,	/**< Solve it through a path formulation using column generation (price-and-branch). **/
+		METHOD_CPLEX_BACKEND = 5,	/**< Solve the backend-neutral routing model through a MIP using the CPLEX Callable Library. **/
+		METHOD_PATH_ENGINE = 6,	/**< Solve the backend-neutral routing model with the embedded path engine, which does not require CPLEX. **/
+		METHOD_LABEL_SETTING = 7,	/**< Solve it exactly with a bidirectional label-setting algorithm pruned by the subgradient bounds. **/
+		METHOD_MULTI_START_SUBGRADIENT = 8,	/**< Solve it by running several subgradient trajectories in parallel, sharing their bounds. **/
+		METHOD_LAGRANGIAN_CPLEX = 9,	/**< Solve it with the subgradient method, then through a MIP using CPLEX on the arcs not fixed by Lagrangian reduced costs. **/
+		METHOD_KSP_FIRST_FIT = 10	/**< Route each demand on the lowest free window of its k shortest physical paths, without building the extended graphs. **/
+	};
+
+	/** Enumerates the possible rules for updating the lagrangian multipliers in the subgradient method. **/
+	enum MultiplierUpdate {
+		MULTIPLIER_UPDATE_SUBGRADIENT = 0,	/**< Move along the subgradient with a Polyak step whose lambda is halved when the bound stalls. **/
+		MULTIPLIER_UPDATE_DEFLECTED = 1,	/**< Move along the subgradient deflected by the previous direction to reduce zig-zagging. **/
+		MULTIPLIER_UPDATE_VOLUME = 2,		/**< Move from the best multipliers along a running average of subgradients, which also gives primal estimates. **/
+		MULTIPLIER_UPDATE_BUNDLE = 3		/**< Maximize a proximal cutting-plane model of the lagrangian function, with cut aggregation. **/
 	};
 
 	/** Enumerates the possible levels of applying a preprocessing step fo reducing the graphs before optimization is called. **/
@@ -45,17 +62,26 @@ private:
 	std::string onlineDemandFolder;		/**< Path to the folder containing the files on the non-routed demands. **/
 	std::vector< std::string > vecOnlineDemandFile;	/**< A vector storing the paths to the files containing information on the non-routed demands. **/
 	std::string outputPath;				/**< Path to the folder where the output files will be sent by the end of the optimization procedure.**/
+	std::string pathCacheFolder;		/**< Path to the folder where the shortest paths of each pair of nodes are kept between runs. If empty, they are not kept on disk.**/
 	
     int nbDemandsAtOnce;				/**< How many demands are treated in a single optimization.**/
 	int nbSlicesInOutputFile;			/**< How many slices will be displayed in the output file. **/
 	Method chosenMethod;				/**< Refers to which method is applied for solving the problem.**/
 	PreprocessingLevel chosenPreprLvl;	/**< Refers to which level of preprocessing is applied before solving the problem.**/
 	ObjectiveMetric chosenObj;			/**< Refers to which objective is optimized.**/
+	int nbThreads;						/**< How many threads can be used when building a model. If non-positive, all available cores are used.**/
+	bool modelNames;					/**< If true, names are given to the variables and constraints of the models built in bulk.**/
+	bool lengthCoverCuts;				/**< If true, cover inequalities on the length constraints are separated while solving the MIP.**/
 
 	double lagrangianMultiplier_zero;	/**< The initial value of the lagrangian multiplier used if subgradient method is chosen. **/
 	double lagrangianLambda_zero;		/**< The initial value of the lambda used for computing the step size if subgradient method is chosen. **/
 	int nbIterationsWithoutImprovement;	/**< The maximal number of iterations allowed in the subgradient method.**/
 	int maxNbIterations;				/**< The maximal number of iterations allowed without improving the lower bound in the subgradient method.**/
+	int maxNbPricingIterations;			/**< The maximal number of pricing rounds allowed in the column generation method.**/
+	MultiplierUpdate chosenMultiplierUpdate;	/**< Refers to which rule updates the lagrangian multipliers in the subgradient method.**/
+	double targetGap;					/**< The relative gap whose first iteration and time are reported by the subgradient method.**/
+	int nbSubgradientStarts;			/**< How many subgradient trajectories are run in parallel by the multi-start subgradient method.**/
+	int nbCandidatePaths;				/**< How many shortest paths are tried for each demand by the k-shortest paths first-fit method.**/
 public:
 	/****************************************************************************************/
 	/*									Constructors										*/
@@ -95,6 +121,9 @@ public:
 
 	/** Returns the path to the folder where the output files will be sent by the end of the optimization procedure.**/
     std::string getOutputPath() const { return outputPath; }
+
+	/** Returns the path to the folder where the shortest paths of each pair of nodes are kept between runs, empty if they are not kept on disk.**/
+    std::string getPathCacheFolder() const { return pathCacheFolder; }
 	
 	/** Returns the number of demands to be treated in a single optimization. **/
     int getNbDemandsAtOnce() const {return nbDemandsAtOnce;}
@@ -111,6 +140,15 @@ public:
 	/** Returns the identifier of the objective chosen to be optimized. **/
     ObjectiveMetric getChosenObj() const {return chosenObj;}
 
+	/** Returns the number of threads that can be used when building a model. If non-positive, all available cores are used. **/
+	int getNbThreads() const { return nbThreads; }
+
+	/** Returns true if names should be given to the variables and constraints of the models built in bulk. **/
+	bool getModelNames() const { return modelNames; }
+
+	/** Returns true if cover inequalities on the length constraints should be separated while solving the MIP. **/
+	bool getLengthCoverCuts() const { return lengthCoverCuts; }
+
 	/** Returns the initial value of the lagrangian multiplier used if subgradient method is chosen. **/
 	double getInitialLagrangianMultiplier() const { return lagrangianMultiplier_zero; }
 	
@@ -123,6 +161,21 @@ public:
 	/** Returns the maximal number of iterations allowed without improving the lower bound in the subgradient method.**/
 	int getMaxNbIterations() const { return maxNbIterations; }
 
+	/** Returns the maximal number of pricing rounds allowed in the column generation method.**/
+	int getMaxNbPricingIterations() const { return maxNbPricingIterations; }
+
+	/** Returns the rule updating the lagrangian multipliers in the subgradient method.**/
+	MultiplierUpdate getChosenMultiplierUpdate() const { return chosenMultiplierUpdate; }
+
+	/** Returns the relative gap whose first iteration and time are reported by the subgradient method.**/
+	double getTargetGap() const { return targetGap; }
+
+	/** Returns how many subgradient trajectories are run in parallel by the multi-start subgradient method.**/
+	int getNbSubgradientStarts() const { return nbSubgradientStarts; }
+
+	/** Returns how many shortest paths are tried for each demand by the k-shortest paths first-fit method.**/
+	int getNbCandidatePaths() const { return nbCandidatePaths; }
+
 	/****************************************************************************************/
 	/*										Methods											*/
 	/****************************************************************************************/
@@ -0,0 +1,108 @@
+#include "kspFirstFit.h"
+
+#include <algorithm>
+
+/* Constructor. Routes the demands of the next optimization one at a time. */
+KspFirstFit::KspFirstFit(const Instance &inst, PathCache *pathCache) : instance(inst), toBeRouted(inst.getNextDemands()),
+        ownCache(inst.getInput().getNbCandidatePaths(), ""), cache(pathCache), isFeasible(false) {
+
+    std::cout << "--- K-shortest paths first-fit was invoked ---" << std::endl;
+    if (cache == NULL){
+        cache = &ownCache;
+    }
+    cache->setTopology(instance);
+    /* Unless a single thread is requested (non-positive values mean every core), every pair is computed at once; afterwards the cache is only read. */
+    if (instance.getInput().getNbThreads() != 1){
+        cache->fillAll(instance.getInput().getNbThreads());
+    }
+    isUsed.assign(instance.getNbEdges(), std::vector<bool>());
+    for (int i = 0; i < instance.getNbEdges(); i++){
+        PhysicalLink link = instance.getPhysicalLinkFromId(i);
+        for (int s = 0; s < link.getNbSlices(); s++){
+            isUsed[i].push_back(link.getSlice_i(s).isUsed());
+        }
+    }
+    vecPathLinks.resize(toBeRouted.size());
+    vecPathSlice.assign(toBeRouted.size(), -1);
+
+    isFeasible = true;
+    for (unsigned int d = 0; d < toBeRouted.size(); d++){
+        if (route(d) == false){
+            std::cout << "> Demand " << toBeRouted[d].getId() + 1 << " could not be routed." << std::endl;
+            isFeasible = false;
+            break;
+        }
+        displayPath(d);
+    }
+}
+
+/* Routes the d-th demand on the lowest free window of its candidate paths and returns false if there is none. */
+bool KspFirstFit::route(int d){
+    const Demand &demand = toBeRouted[d];
+    /* Not even the shortest physical path respects the maximal length. */
+    if (instance.getShortestDistance(demand.getSource(), demand.getTarget()) > demand.getMaxLength()){
+        return false;
+    }
+    const std::vector<PathCache::CachedPath> &paths = cache->getPaths(demand.getSource(), demand.getTarget());
+    int bestPath = -1;
+    int bestSlice = -1;
+    /* Paths are sorted by increasing length: the first one too long ends the candidates. */
+    for (unsigned int p = 0; p < paths.size() && paths[p].length <= demand.getMaxLength(); p++){
+        int slice = getFirstFit(paths[p].links, demand.getLoad());
+        if (slice != -1 && (bestPath == -1 || slice < bestSlice)){
+            bestPath = p;
+            bestSlice = slice;
+        }
+    }
+    if (bestPath == -1){
+        return false;
+    }
+    vecPathLinks[d] = paths[bestPath].links;
+    vecPathSlice[d] = bestSlice;
+    for (unsigned int k = 0; k < vecPathLinks[d].size(); k++){
+        for (int s = bestSlice - demand.getLoad() + 1; s <= bestSlice; s++){
+            isUsed[vecPathLinks[d][k]][s] = true;
+        }
+    }
+    return true;
+}
+
+/* Returns the last slice of the lowest window of load consecutive slices free on every link of a path, or -1 if there is none. */
+int KspFirstFit::getFirstFit(const std::vector<int> &links, int load){
+    int nbSlices = INT_MAX;
+    for (unsigned int k = 0; k < links.size(); k++){
+        nbSlices = std::min(nbSlices, (int)isUsed[links[k]].size());
+    }
+    int nbFree = 0;
+    for (int s = 0; s < nbSlices; s++){
+        bool isFree = true;
+        for (unsigned int k = 0; k < links.size() && isFree; k++){
+            isFree = !isUsed[links[k]][s];
+        }
+        nbFree = isFree ? nbFree + 1 : 0;
+        if (nbFree >= load){
+            return s;
+        }
+    }
+    return -1;
+}
+
+/* Updates the instance with the windows assigned to every demand. */
+void KspFirstFit::updateInstance(Instance &i){
+    for (unsigned int d = 0; d < toBeRouted.size(); d++){
+        Demand demand = i.getDemandFromIndex(toBeRouted[d].getId());
+        for (unsigned int k = 0; k < vecPathLinks[d].size(); k++){
+            i.assignSlicesOfLink(vecPathLinks[d][k], vecPathSlice[d], demand);
+        }
+    }
+    i.displaySlices();
+}
+
+/* Displays the path and window assigned to the d-th demand. */
+void KspFirstFit::displayPath(int d){
+    std::cout << "> Demand " << toBeRouted[d].getId() + 1 << " (load " << toBeRouted[d].getLoad() << ") is routed on links";
+    for (unsigned int k = 0; k < vecPathLinks[d].size(); k++){
+        std::cout << " " << vecPathLinks[d][k] + 1;
+    }
+    std::cout << " with last slice " << vecPathSlice[d] + 1 << "." << std::endl;
+}
@@ -0,0 +1,61 @@
+#ifndef __kspFirstFit__h
+#define __kspFirstFit__h
+
+#include "Instance.h"
+#include "pathCache.h"
+
+/*********************************************************************************************
+* This class routes the demands of the next optimization one at a time, without building any
+* extended graph. For each demand, the k shortest loopless paths of the physical network are
+* looked up in a path cache, and those within the maximal length are the candidates. The free
+* slices of the links of each candidate are intersected, and the demand is assigned to the
+* lowest window of consecutive free slices, ties being broken by the shorter path. The window is
+* reserved before the next demand is routed. The instance is only updated, through
+* updateInstance, if every demand has been routed.
+* \note This is a heuristic: when it fails, an exact method may still find a solution.
+*********************************************************************************************/
+class KspFirstFit {
+
+private:
+    const Instance &instance;                           /**< The instance describing the current mapping. **/
+    std::vector<Demand> toBeRouted;                     /**< The demands to be routed in this optimization. **/
+    PathCache ownCache;                                 /**< The cache used if none is given. **/
+    PathCache *cache;                                   /**< The cache of the k shortest paths of each pair of nodes. **/
+    std::vector< std::vector<bool> > isUsed;            /**< isUsed[link][slice] is true if the slice is taken in the instance or by a demand routed earlier. **/
+    std::vector< std::vector<int> > vecPathLinks;       /**< vecPathLinks[d] stores the links of the path assigned to the d-th demand. **/
+    std::vector<int> vecPathSlice;                      /**< vecPathSlice[d] is the last slice of the window assigned to the d-th demand. **/
+    bool isFeasible;                                    /**< True if every demand has been routed. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+    /** Constructor. Routes the demands of the next optimization. @param inst The instance. @param pathCache The cache of shortest paths kept across optimizations; if NULL, paths are only kept during this one. **/
+    KspFirstFit(const Instance &inst, PathCache *pathCache = NULL);
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+    /** Returns true if every demand has been routed. **/
+    bool getIsFeasible() const { return isFeasible; }
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+    /** Routes the d-th demand on the lowest free window of its candidate paths and returns false if there is none. @param d The demand index. **/
+    bool route(int d);
+
+    /** Returns the last slice of the lowest window of load consecutive slices free on every link of a path, or -1 if there is none. @param links The links of the path. @param load The number of slices required. **/
+    int getFirstFit(const std::vector<int> &links, int load);
+
+    /** Updates the instance with the windows assigned to every demand. @param i The instance to be updated. **/
+    void updateInstance(Instance &i);
+
+	/****************************************************************************************/
+	/*										Display											*/
+	/****************************************************************************************/
+    /** Displays the path and window assigned to the d-th demand. @param d The demand index. **/
+    void displayPath(int d);
+};
+
+#endif
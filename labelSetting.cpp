@@ -0,0 +1,283 @@
+#include "labelSetting.h"
+
+#include <queue>
+
+
+LabelSetting::LabelSetting(const Instance &inst, MultiplierCache *multiplierCache) : Subgradient(inst, multiplierCache), nbLabels(0) {
+
+    std::cout << "--- Label setting was invoked ---" << std::endl;
+    if (getIsFeasible() == false){
+        std::cout << "> No feasible solution is known. Label setting is not run." << std::endl;
+        return;
+    }
+    runLabelSetting();
+
+}
+
+/* Solves the constrained shortest path of every demand exactly, starting from the subgradient solution. */
+void LabelSetting::runLabelSetting(){
+    if (getIsOptimal()){
+        std::cout << "> Subgradient has already proven optimality (UB = " << getUB() << ", LB = " << getLB() << ")." << std::endl;
+        return;
+    }
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        /* The slice windows taken by the other demands are forbidden. */
+        isReserved.assign(instance.getNbEdges(), std::vector<bool>(nbSlices, false));
+        for (int d2 = 0; d2 < getNbDemandsToBeRouted(); d2++){
+            if (d2 != d){
+                reservePath(d2, getCurrentPath(d2));
+            }
+        }
+        double incumbentCost = getPathCost(d, getCurrentPath(d));
+        std::vector<ListDigraph::Arc> path;
+        if (solveDemand(d, incumbentCost, path)){
+            for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+                (*vecOnPath[d])[a] = -1;
+            }
+            for (unsigned int i = 0; i < path.size(); i++){
+                (*vecOnPath[d])[path[i]] = getToBeRouted_k(d).getId();
+            }
+            setUB(getUB() - incumbentCost + getPathCost(d, path));
+            std::cout << "> Demand " << getToBeRouted_k(d).getId()+1 << " improved from " << incumbentCost << " to " << getPathCost(d, path) << ": " << getPathString(d, path) << std::endl;
+        }
+    }
+    /* With a single demand, the search is exhaustive: the incumbent is optimal. */
+    if (getNbDemandsToBeRouted() == 1 || getLB() >= getUB() - EPSILON){
+        setIsOptimal(true);
+        setLB(getUB());
+    }
+    std::cout << "> Number of labels: " << getNbLabels() << std::endl;
+    if (getIsOptimal()){
+        std::cout << "> Optimal solution found (cost = " << getUB() << "):" << std::endl;
+    }
+    else{
+        std::cout << "> Each path is optimal given the other ones (UB = " << getUB() << ", LB = " << getLB() << "):" << std::endl;
+    }
+    displayPaths();
+}
+
+/* Searches for a path of graph #d cheaper than incumbentCost within the length limit. */
+bool LabelSetting::solveDemand(int d, double incumbentCost, std::vector<ListDigraph::Arc> &path){
+    buildArrays(d);
+    const int source = (*vecGraph[d]).id(vecSource[d]);
+    const int target = (*vecGraph[d]).id(vecTarget[d]);
+    const double multiplier = getLengthMultiplier_d(d);
+    std::vector<double> lagrangianCost(arcCost.size());
+    for (unsigned int a = 0; a < arcCost.size(); a++){
+        lagrangianCost[a] = arcCost[a] + multiplier*arcLength[a];
+    }
+    computeDistances(target, false, lagrangianCost, toTargetCost);
+    computeDistances(target, false, arcLength, toTargetLength);
+    computeDistances(source, true, lagrangianCost, fromSourceCost);
+    computeDistances(source, true, arcLength, fromSourceLength);
+
+    const double halfLength = getToBeRouted_k(d).getMaxLength()/2.0;
+    extendLabels(d, true, halfLength, incumbentCost);
+    extendLabels(d, false, halfLength, incumbentCost);
+    return joinLabels(d, incumbentCost, path);
+}
+
+/* Copies graph #d into flat arrays, leaving out the arcs whose slice window is taken by another demand. */
+void LabelSetting::buildArrays(int d){
+    const ListDigraph &graph = *vecGraph[d];
+    int nbArcs = graph.maxArcId() + 1;
+    int nbNodes = graph.maxNodeId() + 1;
+    arcTail.assign(nbArcs, -1);
+    arcHead.assign(nbArcs, -1);
+    arcCost.assign(nbArcs, 0.0);
+    arcLength.assign(nbArcs, 0.0);
+    outArcs.assign(nbNodes, std::vector<int>());
+    inArcs.assign(nbNodes, std::vector<int>());
+    for (ListDigraph::ArcIt a(graph); a != INVALID; ++a){
+        int id = graph.id(a);
+        arcTail[id] = graph.id(graph.source(a));
+        arcHead[id] = graph.id(graph.target(a));
+        arcCost[id] = vecFlatBaseCost[d][id];
+        arcLength[id] = vecFlatLength[d][id];
+        if (isWindowFree(d, a)){
+            outArcs[arcTail[id]].push_back(id);
+            inArcs[arcHead[id]].push_back(id);
+        }
+    }
+}
+
+/* Computes the shortest distances from root with the given arc weights, following arcs forward or backward. */
+void LabelSetting::computeDistances(int root, bool forward, const std::vector<double> &weight, std::vector<double> &dist){
+    typedef std::pair<double, int> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    dist.assign(outArcs.size(), __DBL_MAX__);
+    dist[root] = 0.0;
+    heap.push(Entry(0.0, root));
+    while (!heap.empty()){
+        double nodeDist = heap.top().first;
+        int node = heap.top().second;
+        heap.pop();
+        if (nodeDist > dist[node]){
+            continue;
+        }
+        const std::vector<int> &arcs = forward ? outArcs[node] : inArcs[node];
+        for (unsigned int k = 0; k < arcs.size(); k++){
+            int next = forward ? arcHead[arcs[k]] : arcTail[arcs[k]];
+            if (nodeDist + weight[arcs[k]] < dist[next]){
+                dist[next] = nodeDist + weight[arcs[k]];
+                heap.push(Entry(dist[next], next));
+            }
+        }
+    }
+}
+
+/* Extends the labels of one direction from its root while their length is at most halfLength. */
+void LabelSetting::extendLabels(int d, bool forward, double halfLength, double incumbentCost){
+    const int root = (*vecGraph[d]).id(forward ? vecSource[d] : vecTarget[d]);
+    const int end = (*vecGraph[d]).id(forward ? vecTarget[d] : vecSource[d]);
+    const double maxLength = getToBeRouted_k(d).getMaxLength();
+    const double multiplier = getLengthMultiplier_d(d);
+    const std::vector<double> &boundCost = forward ? toTargetCost : fromSourceCost;
+    const std::vector<double> &boundLength = forward ? toTargetLength : fromSourceLength;
+    std::vector<PathLabel> &labels = forward ? forwardLabels : backwardLabels;
+    labels.clear();
+    (forward ? forwardNodeLabels : backwardNodeLabels).assign(outArcs.size(), std::vector<int>());
+
+    /* Labels are extended by increasing Lagrangian bound on the cost of their best completion. */
+    typedef std::pair<double, int> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    PathLabel start = {root, 0.0, 0.0, -1, -1, false};
+    addLabel(forward, start);
+    heap.push(Entry(boundCost[root], 0));
+    while (!heap.empty()){
+        int current = heap.top().second;
+        heap.pop();
+        if (labels[current].isDominated || labels[current].node == end){
+            continue;
+        }
+        const std::vector<int> &arcs = forward ? outArcs[labels[current].node] : inArcs[labels[current].node];
+        for (unsigned int k = 0; k < arcs.size(); k++){
+            int a = arcs[k];
+            int next = forward ? arcHead[a] : arcTail[a];
+            /* Nothing enters the source and nothing leaves the target. */
+            if (next == root || boundCost[next] >= __DBL_MAX__){
+                continue;
+            }
+            PathLabel label = {next, labels[current].cost + arcCost[a], labels[current].length + arcLength[a], current, a, false};
+            if (label.length > halfLength + EPSILON || label.length + boundLength[next] > maxLength + EPSILON){
+                continue;
+            }
+            /* For any u >= 0, the cost of a feasible path is at least its Lagrangian cost minus u*maxLength. */
+            double bound = label.cost + multiplier*label.length + boundCost[next];
+            if (bound - multiplier*maxLength >= incumbentCost - EPSILON){
+                continue;
+            }
+            if (addLabel(forward, label)){
+                heap.push(Entry(bound, (int)labels.size() - 1));
+            }
+        }
+    }
+}
+
+/* Adds a label to one direction unless it is dominated at its node, and returns true if it has been added. */
+bool LabelSetting::addLabel(bool forward, const PathLabel &label){
+    std::vector<PathLabel> &labels = forward ? forwardLabels : backwardLabels;
+    std::vector<int> &current = forward ? forwardNodeLabels[label.node] : backwardNodeLabels[label.node];
+    for (unsigned int k = 0; k < current.size(); k++){
+        const PathLabel &other = labels[current[k]];
+        if (other.cost <= label.cost + EPSILON && other.length <= label.length + EPSILON){
+            return false;
+        }
+    }
+    std::vector<int> kept;
+    for (unsigned int k = 0; k < current.size(); k++){
+        PathLabel &other = labels[current[k]];
+        if (label.cost <= other.cost + EPSILON && label.length <= other.length + EPSILON){
+            other.isDominated = true;
+        }
+        else{
+            kept.push_back(current[k]);
+        }
+    }
+    labels.push_back(label);
+    kept.push_back((int)labels.size() - 1);
+    current.swap(kept);
+    nbLabels++;
+    return true;
+}
+
+/* Joins forward and backward labels through every arc and stores the cheapest path within the length limit, if cheaper than incumbentCost. The virtual arcs are left out of the path. */
+bool LabelSetting::joinLabels(int d, double incumbentCost, std::vector<ListDigraph::Arc> &path){
+    const int source = (*vecGraph[d]).id(vecSource[d]);
+    const int target = (*vecGraph[d]).id(vecTarget[d]);
+    const double maxLength = getToBeRouted_k(d).getMaxLength();
+
+    /* Backward labels of each node are sorted by length. cheapest[n][k] is the cheapest among the first k+1 of them. */
+    std::vector< std::vector<int> > cheapest(backwardNodeLabels.size());
+    for (unsigned int n = 0; n < backwardNodeLabels.size(); n++){
+        std::vector<int> &nodeLabels = backwardNodeLabels[n];
+        std::sort(nodeLabels.begin(), nodeLabels.end(), [&](int l1, int l2){ return backwardLabels[l1].length < backwardLabels[l2].length; });
+        for (unsigned int k = 0; k < nodeLabels.size(); k++){
+            if (k == 0 || backwardLabels[nodeLabels[k]].cost < backwardLabels[cheapest[n].back()].cost){
+                cheapest[n].push_back(nodeLabels[k]);
+            }
+            else{
+                cheapest[n].push_back(cheapest[n].back());
+            }
+        }
+    }
+
+    /* Every feasible path has an arc (i,j) such that the part up to i and the part from j are both within half the length limit. */
+    double bestCost = incumbentCost - EPSILON;
+    int bestForward = -1, bestArc = -1, bestBackward = -1;
+    for (int i = 0; i < (int)outArcs.size(); i++){
+        if (i == target){
+            continue;
+        }
+        for (unsigned int e = 0; e < outArcs[i].size(); e++){
+            int a = outArcs[i][e];
+            int j = arcHead[a];
+            if (j == source){
+                continue;
+            }
+            const std::vector<int> &nodeLabels = backwardNodeLabels[j];
+            for (unsigned int k = 0; k < forwardNodeLabels[i].size(); k++){
+                const PathLabel &label = forwardLabels[forwardNodeLabels[i][k]];
+                double limit = maxLength - label.length - arcLength[a] + EPSILON;
+                int last = (int)(std::upper_bound(nodeLabels.begin(), nodeLabels.end(), limit, [&](double l, int b){ return l < backwardLabels[b].length; }) - nodeLabels.begin()) - 1;
+                if (last < 0){
+                    continue;
+                }
+                int b = cheapest[j][last];
+                double cost = label.cost + arcCost[a] + backwardLabels[b].cost;
+                if (cost < bestCost){
+                    bestCost = cost;
+                    bestForward = forwardNodeLabels[i][k];
+                    bestArc = a;
+                    bestBackward = b;
+                }
+            }
+        }
+    }
+    if (bestArc == -1){
+        return false;
+    }
+
+    path.clear();
+    for (int l = bestForward; forwardLabels[l].predecessor != -1; l = forwardLabels[l].predecessor){
+        path.push_back((*vecGraph[d]).arcFromId(forwardLabels[l].arc));
+    }
+    std::reverse(path.begin(), path.end());
+    path.push_back((*vecGraph[d]).arcFromId(bestArc));
+    for (int l = bestBackward; backwardLabels[l].predecessor != -1; l = backwardLabels[l].predecessor){
+        path.push_back((*vecGraph[d]).arcFromId(backwardLabels[l].arc));
+    }
+    path.erase(std::remove_if(path.begin(), path.end(), [&](const ListDigraph::Arc &a){ return isVirtualArc(a, d); }), path.end());
+    return true;
+}
+
+/* Returns the arcs of the current path of graph #d. */
+std::vector<ListDigraph::Arc> LabelSetting::getCurrentPath(int d){
+    std::vector<ListDigraph::Arc> path;
+    for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+        if ((*vecOnPath[d])[a] != -1){
+            path.push_back(a);
+        }
+    }
+    return path;
+}
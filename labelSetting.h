@@ -0,0 +1,85 @@
+#ifndef __labelSetting__h
+#define __labelSetting__h
+
+#include "subgradient.h"
+
+/* Exact resolution of the constrained shortest path of each demand by a bidirectional label-setting algorithm. The
+   subgradient method is run first: its upper bound and feasible paths are the incumbent, and its length multipliers
+   give Lagrangian bounds used to prune labels. Forward labels (from the source) and backward labels (from the target)
+   store (cost, length) pairs with Pareto dominance, and each side only explores half of the length limit before both
+   sides are joined through an arc. With several demands, each one is solved exactly while the others keep their paths. */
+class LabelSetting : public Subgradient {
+
+private:
+    /* A partial path: from the source to node for forward labels, from node to the target for backward labels. */
+    struct PathLabel {
+        int node;
+        double cost;
+        double length;
+        int predecessor;    /* the label it has been extended from, -1 for the first label */
+        int arc;            /* the id of the arc used for extending the predecessor */
+        bool isDominated;
+    };
+
+    /* the total number of labels created */
+    int nbLabels;
+
+    /* flat copy of graph #d indexed by node and arc ids. Arcs whose slice window is taken by another demand are left out of outArcs and inArcs */
+    std::vector<int> arcTail;
+    std::vector<int> arcHead;
+    std::vector<double> arcCost;
+    std::vector<double> arcLength;
+    std::vector< std::vector<int> > outArcs;
+    std::vector< std::vector<int> > inArcs;
+
+    /* shortest distances from each node to the target and from the source to each node, with Lagrangian costs and with lengths */
+    std::vector<double> toTargetCost;
+    std::vector<double> toTargetLength;
+    std::vector<double> fromSourceCost;
+    std::vector<double> fromSourceLength;
+
+    /* the labels of each direction, and the labels stored at each node */
+    std::vector<PathLabel> forwardLabels;
+    std::vector<PathLabel> backwardLabels;
+    std::vector< std::vector<int> > forwardNodeLabels;
+    std::vector< std::vector<int> > backwardNodeLabels;
+
+public:
+	/************************************************/
+	/*				    Constructors 		   		*/
+	/************************************************/
+    LabelSetting(const Instance &inst, MultiplierCache *multiplierCache = NULL);
+
+	/************************************************/
+	/*					   Getters 		    		*/
+	/************************************************/
+    int getNbLabels() const { return nbLabels; }
+
+	/************************************************/
+	/*					   Methods 		    		*/
+	/************************************************/
+    /* Solves the constrained shortest path of every demand exactly, starting from the subgradient solution. */
+    void runLabelSetting();
+
+    /* Searches for a path of graph #d cheaper than incumbentCost within the length limit. Returns false if there is none. */
+    bool solveDemand(int d, double incumbentCost, std::vector<ListDigraph::Arc> &path);
+
+    /* Copies graph #d into flat arrays, leaving out the arcs whose slice window is taken by another demand. */
+    void buildArrays(int d);
+
+    /* Computes the shortest distances from root with the given arc weights, following arcs forward or backward. */
+    void computeDistances(int root, bool forward, const std::vector<double> &weight, std::vector<double> &dist);
+
+    /* Extends the labels of one direction from its root while their length is at most halfLength. A label is pruned if every completion is not cheaper than incumbentCost or exceeds the length limit. */
+    void extendLabels(int d, bool forward, double halfLength, double incumbentCost);
+
+    /* Adds a label to one direction unless it is dominated at its node, and returns true if it has been added. */
+    bool addLabel(bool forward, const PathLabel &label);
+
+    /* Joins forward and backward labels through every arc and stores the cheapest path within the length limit, if cheaper than incumbentCost. */
+    bool joinLabels(int d, double incumbentCost, std::vector<ListDigraph::Arc> &path);
+
+    /* Returns the arcs of the current path of graph #d. */
+    std::vector<ListDigraph::Arc> getCurrentPath(int d);
+};
+#endif
@@ -0,0 +1,84 @@
+#include "lengthCoverCallback.h"
+
+/* Constructor. */
+LengthCoverCallback::LengthCoverCallback(IloEnv env, const IloNumVarMatrix &var, const std::vector< std::vector<double> > &len, const std::vector<double> &maxLen, std::atomic<int> *counter) :
+                                        IloCplex::UserCutCallbackI(env), x(var), length(len), maxLength(maxLen), nbCuts(counter){
+}
+
+/* Copy constructor. Copies share the variables and the cut counter. */
+LengthCoverCallback::LengthCoverCallback(const LengthCoverCallback &callback) : IloCplex::UserCutCallbackI(callback),
+                                        x(callback.x), length(callback.length), maxLength(callback.maxLength), nbCuts(callback.nbCuts){
+}
+
+/* Returns a copy of the callback, required by CPLEX when solving in parallel. */
+IloCplex::CallbackI* LengthCoverCallback::duplicateCallback() const {
+    return (new (getEnv()) LengthCoverCallback(*this));
+}
+
+/* Separates length cover inequalities for every demand from the current fractional solution. */
+void LengthCoverCallback::main(){
+    for (unsigned int d = 0; d < length.size(); d++){
+        IloNumArray value(getEnv());
+        getValues(value, x[d]);
+        separate(d, value);
+        value.end();
+    }
+}
+
+/* Searches for a violated extended cover inequality on the length constraint of the d-th demand and adds it. */
+bool LengthCoverCallback::separate(int d, const IloNumArray &value){
+    const std::vector<double> &len = length[d];
+
+    /* Arcs taken in the LP solution, preferring those that are almost fully used and long. */
+    std::vector<int> candidate;
+    for (unsigned int i = 0; i < len.size(); i++){
+        if (len[i] > EPSILON && value[i] > EPSILON){
+            candidate.push_back(i);
+        }
+    }
+    std::sort(candidate.begin(), candidate.end(), [&](int i, int j){ return (1.0 - value[i])/len[i] < (1.0 - value[j])/len[j]; });
+
+    /* Greedy cover. */
+    std::vector<int> cover;
+    double coverLength = 0.0;
+    for (unsigned int k = 0; k < candidate.size() && coverLength <= maxLength[d] + EPSILON; k++){
+        cover.push_back(candidate[k]);
+        coverLength += len[candidate[k]];
+    }
+    if (coverLength <= maxLength[d] + EPSILON){
+        return false;
+    }
+
+    /* Make it minimal, dropping first the arcs that were added last. */
+    for (int k = (int)cover.size() - 1; k >= 0; k--){
+        if (coverLength - len[cover[k]] > maxLength[d] + EPSILON){
+            coverLength -= len[cover[k]];
+            cover.erase(cover.begin() + k);
+        }
+    }
+
+    /* Extended cover: every arc at least as long as the longest arc in the cover. */
+    double longest = 0.0;
+    std::vector<bool> inCover(len.size(), false);
+    for (unsigned int k = 0; k < cover.size(); k++){
+        longest = std::max(longest, len[cover[k]]);
+        inCover[cover[k]] = true;
+    }
+    double lhs = 0.0;
+    IloExpr exp(getEnv());
+    for (unsigned int i = 0; i < len.size(); i++){
+        if (inCover[i] || len[i] >= longest - EPSILON){
+            lhs += value[i];
+            exp += x[d][i];
+        }
+    }
+    const double rhs = (double)cover.size() - 1.0;
+    bool isAdded = false;
+    if (lhs > rhs + VIOLATION_TOLERANCE){
+        add(exp <= rhs, IloCplex::UseCutPurge);
+        (*nbCuts)++;
+        isAdded = true;
+    }
+    exp.end();
+    return isAdded;
+}
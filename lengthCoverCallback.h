@@ -0,0 +1,55 @@
+#ifndef __lengthCoverCallback__h
+#define __lengthCoverCallback__h
+
+#include <ilcplex/ilocplex.h>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+typedef IloArray<IloNumVarArray> IloNumVarMatrix;
+
+
+/*********************************************************************************************
+* This class implements a CPLEX user cut callback separating cover inequalities from the length
+* constraint of each demand. For a demand d, the length constraint sum(length[a]*x[d][a]) <=
+* maxLength is a knapsack row. A set C of arcs whose total length exceeds maxLength cannot be
+* entirely used, so sum(x[d][a] : a in C) <= |C| - 1. The cover is found greedily from the
+* fractional solution, made minimal, and extended with every arc at least as long as the
+* longest arc in C (extended cover), which lifts the inequality at no cost.
+*********************************************************************************************/
+class LengthCoverCallback : public IloCplex::UserCutCallbackI {
+
+private:
+    const double EPSILON = 0.000001;
+    const double VIOLATION_TOLERANCE = 0.01;    /**< A cut is added only if it is violated by more than this value. **/
+
+    IloNumVarMatrix x;                          /**< x[d][i] is the variable associated with the i-th arc of graph #d. **/
+    std::vector< std::vector<double> > length;  /**< length[d][i] is the length of the i-th arc of graph #d. **/
+    std::vector<double> maxLength;              /**< maxLength[d] is the maximal length allowed for the d-th demand. **/
+    std::atomic<int> *nbCuts;                   /**< Counts the cuts added by every copy of the callback. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. @param env The CPLEX environment. @param var The variables of the MIP. @param len The length of each arc of each graph. @param maxLen The maximal length of each demand. @param counter The counter of added cuts. **/
+    LengthCoverCallback(IloEnv env, const IloNumVarMatrix &var, const std::vector< std::vector<double> > &len, const std::vector<double> &maxLen, std::atomic<int> *counter);
+
+	/** Copy constructor. Copies share the variables and the cut counter. @param callback The callback to be copied. **/
+    LengthCoverCallback(const LengthCoverCallback &callback);
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+	/** Returns a copy of the callback, required by CPLEX when solving in parallel. **/
+    IloCplex::CallbackI* duplicateCallback() const;
+
+	/** Separates length cover inequalities for every demand from the current fractional solution. **/
+    void main();
+
+	/** Searches for a violated extended cover inequality on the length constraint of the d-th demand and adds it. Returns true if a cut has been added. @param d The demand index. @param value The value of each variable of the d-th demand in the current solution. **/
+    bool separate(int d, const IloNumArray &value);
+};
+
+
+#endif
@@ -1,5 +1,7 @@
+#ifndef NO_CPLEX
 #include <ilcplex/ilocplex.h>
 ILOSTLBEGIN
+#endif
 // cplex10Test.cpp : This file contains the 'main' function. Program execution begins and ends there.
 //
 
@@ -14,8 +16,21 @@ ILOSTLBEGIN
 #include "Instance.h"
 #include "input.h"
 
+#ifndef NO_CPLEX
 #include "cplexForm.h"
+#include "cplexBulkForm.h"
+#include "compactForm.h"
+#include "columnGeneration.h"
+#include "cplexBackend.h"
+#endif
+#include "solver.h"
+#include "pathEngine.h"
 #include "subgradient.h"
+#include "labelSetting.h"
+#include "multiStartSubgradient.h"
+#include "kspFirstFit.h"
+#include "pathCache.h"
+#include "feasibilityGate.h"
 
 using namespace lemon;
 
@@ -31,6 +46,10 @@ int main(int argc, char *argv[]) {
 		}
 		std::cout << "PARAMETER FILE: " << parameterFile << std::endl;
 		Input input(parameterFile);
+		/* Multipliers reached in each optimization, kept for warm-starting the next ones. */
+		MultiplierCache multiplierCache;
+		/* Shortest paths of each pair of nodes, shared by the optimizations since the topology does not change. */
+		PathCache pathCache(input.getNbCandidatePaths(), input.getPathCacheFolder());
 		
 		std::cout << "> Number of online demand files: " << input.getNbOnlineDemandFiles() << std::endl;
 		for (int i = 0; i < input.getNbOnlineDemandFiles(); i++) {
@@ -59,35 +78,194 @@ int main(int argc, char *argv[]) {
 				outputCode = getInBetweenString(nextFile, "/", ".") + "_" + std::to_string(optimizationCounter);
 				std::chrono::_V2::system_clock::time_point start = std::chrono::high_resolution_clock::now();
 
-				switch (instance.getInput().getChosenMethod()){
-				case Input::METHOD_CPLEX:
-					{
-						CplexForm solver(instance);			
-						if (solver.getCplex().getStatus() == IloAlgorithm::Optimal){
-							solver.updateInstance(instance);
-							instance.output(outputCode);
-							//instance.displayDetailedTopology();
+				/* Demands provably infeasible, or routable at their lower bounds, do not need any graph to be built. */
+				FeasibilityGate gate(instance, &pathCache);
+				if (gate.getVerdict() == FeasibilityGate::VERDICT_INFEASIBLE){
+					feasibility = false;
+					instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+				}
+				else if (gate.getVerdict() == FeasibilityGate::VERDICT_TRIVIAL){
+					gate.updateInstance(instance);
+					instance.output(outputCode);
+				}
+				else{
+					switch (instance.getInput().getChosenMethod()){
+#ifndef NO_CPLEX
+					case Input::METHOD_CPLEX:
+						{
+							CplexForm solver(instance);			
+							if (solver.getCplex().getStatus() == IloAlgorithm::Optimal){
+								solver.updateInstance(instance);
+								instance.output(outputCode);
+								//instance.displayDetailedTopology();
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
 						}
-						else{
-							feasibility = false;
-							instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+					case Input::METHOD_CPLEX_BULK:
+						{
+							CplexBulkForm solver(instance);
+							if (solver.isOptimal()){
+								solver.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
 						}
-						break;
-					}
-				case Input::METHOD_SUBGRADIENT:
-					{
-						Subgradient sub(instance);
-						sub.updateInstance(instance);
-						instance.output(outputCode);
-						break;
-					}
-				default:
-					{
-						std::cerr << "The parameter \'chosenMethod\' is invalid. " << std::endl;
-						throw std::invalid_argument( "did not receive an argument" );
-						break;
+					case Input::METHOD_CPLEX_COMPACT:
+						{
+							CompactForm solver(instance);
+							if (solver.getCplex().getStatus() == IloAlgorithm::Optimal){
+								solver.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					case Input::METHOD_COLUMN_GENERATION:
+						{
+							ColumnGeneration solver(instance);
+							if (solver.getIsFeasible()){
+								solver.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					case Input::METHOD_CPLEX_BACKEND:
+						{
+							Solver solver(instance);
+							CplexBackend backend(instance.getInput().getNbThreads());
+							if (solver.solve(backend)){
+								solver.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					case Input::METHOD_LAGRANGIAN_CPLEX:
+						{
+							Subgradient sub(instance, &multiplierCache);
+							if (sub.getIsFeasible() && sub.getIsOptimal()){
+								sub.updateInstance(instance);
+								instance.output(outputCode);
+								break;
+							}
+							if (sub.getIsFeasible()){
+								/* Solutions as good as UB are kept by the fixing and by the cutoff: CPLEX either improves the subgradient solution or proves it optimal. */
+								double cutoff = sub.getUB() + 0.0001*std::max(1.0, std::abs(sub.getUB()));
+								CplexForm solver(instance, sub.getFixedArcs(), cutoff);
+								if (solver.getCplex().getStatus() == IloAlgorithm::Optimal){
+									solver.updateInstance(instance);
+								}
+								else{
+									sub.updateInstance(instance);
+								}
+								instance.output(outputCode);
+								break;
+							}
+							/* No feasible solution is known: nothing can be fixed. */
+							CplexForm solver(instance);
+							if (solver.getCplex().getStatus() == IloAlgorithm::Optimal){
+								solver.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+#endif
+					case Input::METHOD_PATH_ENGINE:
+						{
+							Solver solver(instance);
+							PathEngine backend;
+							if (solver.solve(backend)){
+								solver.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					case Input::METHOD_SUBGRADIENT:
+						{
+							Subgradient sub(instance, &multiplierCache);
+							if (sub.getIsFeasible()){
+								sub.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					case Input::METHOD_LABEL_SETTING:
+						{
+							LabelSetting sub(instance, &multiplierCache);
+							if (sub.getIsFeasible()){
+								sub.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					case Input::METHOD_MULTI_START_SUBGRADIENT:
+						{
+							MultiStartSubgradient sub(instance);
+							if (sub.getIsFeasible()){
+								sub.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					case Input::METHOD_KSP_FIRST_FIT:
+						{
+							KspFirstFit heuristic(instance, &pathCache);
+							if (heuristic.getIsFeasible()){
+								heuristic.updateInstance(instance);
+								instance.output(outputCode);
+							}
+							else{
+								feasibility = false;
+								instance.outputLogResults(getInBetweenString(nextFile, "/", "."));
+							}
+							break;
+						}
+					default:
+						{
+							std::cerr << "The parameter \'chosenMethod\' is invalid. " << std::endl;
+							throw std::invalid_argument( "did not receive an argument" );
+							break;
+						}
+						
 					}
-					
 				}
 			
 				std::chrono::_V2::system_clock::time_point end = std::chrono::high_resolution_clock::now();
@@ -99,7 +277,13 @@ int main(int argc, char *argv[]) {
 			}
 		
 		}
-		
+		if (multiplierCache.getNbHits() + multiplierCache.getNbMisses() > 0){
+			std::cout << "> Multiplier cache: " << multiplierCache.getNbEntries() << " classes of demands, " << multiplierCache.getNbHits() << " hits, " << multiplierCache.getNbMisses() << " misses." << std::endl;
+		}
+		if (pathCache.getNbEntries() > 0){
+			std::cout << "> Path cache: " << pathCache.getNbEntries() << " pairs of nodes, " << pathCache.getNbComputed() << " computed in this run." << std::endl;
+			pathCache.save();
+		}
 
 		//instance.displayInstance();
 	}
@@ -0,0 +1,54 @@
+#include "multiStartSubgradient.h"
+
+#include <thread>
+
+
+MultiStartSubgradient::MultiStartSubgradient(const Instance &inst) : isFeasible(false), isOptimal(false) {
+
+    std::cout << "--- Multi-start subgradient was invoked ---" << std::endl;
+    int nbStarts = std::max(1, inst.getInput().getNbSubgradientStarts());
+    /* A single demand is solved exactly by its length dual, without iterating: every trajectory would find the same result. */
+    if (inst.getNextDemands().size() == 1){
+        nbStarts = 1;
+    }
+    for (int t = 0; t < nbStarts; t++){
+        trajectories.emplace_back(new Subgradient(inst, &shared, t));
+    }
+    std::cout << "> " << nbStarts << " trajectories were initialized. " << std::endl;
+
+    run();
+
+}
+
+/* Runs every trajectory on its own thread and waits for all of them. */
+void MultiStartSubgradient::run(){
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < trajectories.size(); t++){
+        workers.emplace_back(&Subgradient::run, trajectories[t].get());
+    }
+    for (unsigned int t = 0; t < workers.size(); t++){
+        workers[t].join();
+    }
+
+    isFeasible = (shared.owner.load() != -1);
+    isOptimal = isFeasible && (getLB() >= getUB() - 0.0001);
+    displayStatistics();
+    if (isFeasible){
+        std::cout << "> Best solution found by trajectory #" << shared.owner.load()+1 << " (UB = " << getUB() << ", LB = " << getLB() << "):" << std::endl;
+        trajectories[shared.owner.load()]->displayPaths();
+    }
+}
+
+/* Updates the instance with the incumbent. */
+void MultiStartSubgradient::updateInstance(Instance &i){
+    trajectories[shared.owner.load()]->updateInstance(i);
+}
+
+/* Displays the bounds and statistics reached by each trajectory. */
+void MultiStartSubgradient::displayStatistics(){
+    for (unsigned int t = 0; t < trajectories.size(); t++){
+        const Subgradient &trajectory = *trajectories[t];
+        std::cout << "> Trajectory #" << t+1 << ": LB = " << trajectory.getLB() << ", lambda = " << trajectory.getLambda();
+        std::cout << ", iterations: " << trajectory.getIteration() + 1 << ", shortest paths: " << trajectory.getNbShortestPaths() << "." << std::endl;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef __multiStartSubgradient__h
+#define __multiStartSubgradient__h
+
+#include "subgradient.h"
+
+/* Runs several subgradient trajectories in parallel, one per thread, each starting from its own lambda and overlap multipliers. The trajectories
+   share the best bounds through atomics: each one computes its step with the best known UB, and all of them stop once the shared bounds meet.
+   The incumbent stays in the onPath of the trajectory that found it. */
+class MultiStartSubgradient {
+
+private:
+    /* the bounds shared by the trajectories */
+    SharedBounds shared;
+
+    /* the trajectories, built sequentially and run in parallel */
+    std::vector< std::unique_ptr<Subgradient> > trajectories;
+
+    bool isFeasible;
+    bool isOptimal;
+
+public:
+	/************************************************/
+	/*				    Constructors 		   		*/
+	/************************************************/
+    MultiStartSubgradient(const Instance &inst);
+
+	/************************************************/
+	/*					   Getters 		    		*/
+	/************************************************/
+    double getUB() const { return shared.UB.load(); }
+    double getLB() const { return shared.LB.load(); }
+
+    bool getIsFeasible() const { return isFeasible; }
+    bool getIsOptimal() const { return isOptimal; }
+
+	/************************************************/
+	/*					   Methods 		    		*/
+	/************************************************/
+    /* Runs every trajectory on its own thread and waits for all of them. */
+    void run();
+
+    /* Updates the instance with the incumbent. */
+    void updateInstance(Instance &i);
+
+    /************************************************/
+	/*					   Display 		    		*/
+	/************************************************/
+    void displayStatistics();
+};
+#endif
@@ -0,0 +1,27 @@
+#include "multiplierCache.h"
+
+#include <cmath>
+#include <algorithm>
+
+/* Returns the key identifying the class of a demand. Maximal lengths are grouped on a geometric scale of ratio 1.1. */
+MultiplierCache::Key MultiplierCache::getKey(const Demand &demand){
+	int lengthClass = (int) std::floor(std::log(std::max(demand.getMaxLength(), 1.0)) / std::log(1.1));
+	return Key(demand.getSource(), demand.getTarget(), demand.getLoad(), lengthClass);
+}
+
+/* Searches for the values stored for the class of a demand and returns true if they are found. */
+bool MultiplierCache::find(const Demand &demand, Entry &entry){
+	std::map<Key, Entry>::const_iterator it = entries.find(getKey(demand));
+	if (it == entries.end()){
+		nbMisses++;
+		return false;
+	}
+	nbHits++;
+	entry = it->second;
+	return true;
+}
+
+/* Stores the values reached for a demand, replacing those of its class. */
+void MultiplierCache::store(const Demand &demand, const Entry &entry){
+	entries[getKey(demand)] = entry;
+}
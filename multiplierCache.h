@@ -0,0 +1,57 @@
+#ifndef __multiplierCache__h
+#define __multiplierCache__h
+
+#include <map>
+#include <vector>
+#include <tuple>
+
+#include "Demand.h"
+
+/*********************************************************************************************
+* This class stores the lagrangian multipliers reached by the subgradient method for the
+* demands already routed, so that consecutive online optimizations are warm-started. Only the
+* overlap multipliers and lambda are kept, so it only serves batches of several demands: a
+* single demand is solved exactly by its length dual. Demands are identified by their source,
+* target, load and class of maximal length: two demands fall in the same class if their
+* maximal lengths differ by less than about 10%.
+*********************************************************************************************/
+class MultiplierCache {
+
+public:
+	/** The values stored for a class of demands. **/
+	struct Entry {
+		std::vector<double> overlapMultiplier;	/**< The multipliers of the non-overlapping constraints giving the best lower bound, indexed by label*nbSlices + slice. **/
+		double lambda;				/**< The lambda used for computing the step size at the end of the run. **/
+	};
+
+private:
+	typedef std::tuple<int, int, int, int> Key;		/**< (source, target, load, class of maximal length). **/
+
+	std::map<Key, Entry> entries;	/**< The last values stored for each class of demands. **/
+	int nbHits;						/**< How many searches have found an entry. **/
+	int nbMisses;					/**< How many searches have not found an entry. **/
+
+	/** Returns the key identifying the class of a demand. @param demand The demand. **/
+	static Key getKey(const Demand &demand);
+
+public:
+	/** Constructor. The cache is empty. **/
+	MultiplierCache() : nbHits(0), nbMisses(0) {}
+
+	/** Returns the number of classes of demands stored. **/
+	int getNbEntries() const { return (int)entries.size(); }
+
+	/** Returns how many searches have found an entry. **/
+	int getNbHits() const { return nbHits; }
+
+	/** Returns how many searches have not found an entry. **/
+	int getNbMisses() const { return nbMisses; }
+
+	/** Searches for the values stored for the class of a demand and returns true if they are found. @param demand The demand. @param entry Receives the values found. **/
+	bool find(const Demand &demand, Entry &entry);
+
+	/** Stores the values reached for a demand, replacing those of its class. @param demand The demand. @param entry The values to be stored. **/
+	void store(const Demand &demand, const Entry &entry);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef __objectiveMetric__h
+#define __objectiveMetric__h
+
+#include <vector>
+#include <algorithm>
+
+/*********************************************************************************************
+* The objective metrics, as policy classes with a static getCoeff returning the coefficient of
+* an arc of an extended graph. RSA instantiates its coefficient filling once per metric, so the
+* choice of the metric is made once per graph rather than once per arc. Everything a metric
+* needs besides the arc itself is gathered beforehand in MetricData.
+*********************************************************************************************/
+
+/** The data of the current mapping needed by the metrics, computed once per graph. **/
+struct MetricData {
+    int sourceLabel;                        /**< The label of the source of the demand routed on the graph. **/
+    std::vector<int> maxUsedSliceOnLink;    /**< maxUsedSliceOnLink[i] is the last slice position used on link i (0 if none). **/
+    int maxUsedSlice;                       /**< The last slice position used on the whole network (0 if none). **/
+};
+
+/** Metric 1: the max used slice position of each demand, paid on the arcs leaving the source. **/
+struct MetricObj1 {
+    static double getCoeff(int tailLabel, int arcLabel, int arcSlice, double arcLength, const MetricData &data){
+        if (tailLabel == data.sourceLabel){
+            return arcSlice + 1;
+        }
+        return 1.0;
+    }
+};
+
+/** Metric 1p: the max used slice position of each link. @warning Only adapted for the case of treating one demand at a time. **/
+struct MetricObj1p {
+    static double getCoeff(int tailLabel, int arcLabel, int arcSlice, double arcLength, const MetricData &data){
+        return std::max(data.maxUsedSliceOnLink[arcLabel], arcSlice);
+    }
+};
+
+/** Metric 2: the number of hops. **/
+struct MetricObj2 {
+    static double getCoeff(int tailLabel, int arcLabel, int arcSlice, double arcLength, const MetricData &data){
+        return 1.0;
+    }
+};
+
+/** Metric 4: the path length. **/
+struct MetricObj4 {
+    static double getCoeff(int tailLabel, int arcLabel, int arcSlice, double arcLength, const MetricData &data){
+        return arcLength;
+    }
+};
+
+/** Metric 8: the max used slice position overall, paid on the arcs leaving the source. @warning Only adapted for the case of treating one demand at a time. **/
+struct MetricObj8 {
+    static double getCoeff(int tailLabel, int arcLabel, int arcSlice, double arcLength, const MetricData &data){
+        if (tailLabel == data.sourceLabel){
+            return std::max(data.maxUsedSlice, arcSlice) + 1;
+        }
+        return 1.0;
+    }
+};
+
+#endif
@@ -0,0 +1,337 @@
+#include "pathCache.h"
+
+#include <queue>
+#include <limits>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+/* Constructor. The cache is empty until a topology is set. */
+PathCache::PathCache(int k, const std::string &cacheFolder) : nbPaths(std::max(1, k)), folder(cacheFolder),
+        topologyHash(0), nbNodes(0), nbComputed(0) {}
+
+/* Returns the number of pairs computed. */
+int PathCache::getNbEntries() const {
+    return (int)std::count(isFilled.begin(), isFilled.end(), 1);
+}
+
+/* Returns the FNV-1a hash of the number of paths, the nodes, and the endpoints and length of each link. */
+unsigned long long PathCache::computeHash(const Instance &inst) const {
+    unsigned long long hash = 14695981039346656037ULL;
+    std::vector<double> values;
+    values.push_back(nbPaths);
+    values.push_back(inst.getNbNodes());
+    for (int i = 0; i < inst.getNbEdges(); i++){
+        PhysicalLink link = inst.getPhysicalLinkFromId(i);
+        values.push_back(link.getSource());
+        values.push_back(link.getTarget());
+        values.push_back(link.getLength());
+    }
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(values.data());
+    for (unsigned int b = 0; b < values.size()*sizeof(double); b++){
+        hash ^= bytes[b];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* Returns the path of the binary file of the current topology. */
+std::string PathCache::getFileName() const {
+    std::ostringstream name;
+    name << folder << "/paths_" << std::hex << topologyHash << ".bin";
+    return name.str();
+}
+
+/* Sets the topology of the paths. The cache is kept if the topology is unchanged, and loaded from disk otherwise. */
+void PathCache::setTopology(const Instance &inst){
+    unsigned long long hash = computeHash(inst);
+    if (hash == topologyHash && nbNodes == inst.getNbNodes() && !isFilled.empty()){
+        return;
+    }
+    topologyHash = hash;
+    nbNodes = inst.getNbNodes();
+    linkLength.assign(inst.getNbEdges(), 0.0);
+    incident.assign(nbNodes, std::vector< std::pair<int, int> >());
+    for (int i = 0; i < inst.getNbEdges(); i++){
+        PhysicalLink link = inst.getPhysicalLinkFromId(i);
+        linkLength[i] = link.getLength();
+        incident[link.getSource()].push_back(std::make_pair(i, link.getTarget()));
+        incident[link.getTarget()].push_back(std::make_pair(i, link.getSource()));
+    }
+    entries.assign(nbNodes*nbNodes, std::vector<CachedPath>());
+    isFilled.assign(nbNodes*nbNodes, 0);
+    if (!folder.empty() && load()){
+        std::cout << "> Path cache was loaded from " << getFileName() << ": " << getNbEntries() << " pairs." << std::endl;
+    }
+}
+
+/* Computes the paths from u to v and stores them. */
+void PathCache::fill(int u, int v){
+    std::vector<SearchPath> paths;
+    computeShortestPaths(u, v, paths);
+    std::vector<CachedPath> &entry = entries[u*nbNodes + v];
+    entry.resize(paths.size());
+    for (unsigned int p = 0; p < paths.size(); p++){
+        entry[p].length = paths[p].length;
+        entry[p].nbHops = (int)paths[p].links.size();
+        entry[p].links.swap(paths[p].links);
+    }
+    isFilled[u*nbNodes + v] = 1;
+}
+
+/* Fills the pairs whose source is congruent to first modulo step. Each pair is written by a single thread. */
+void PathCache::fillSources(int first, int step){
+    for (int u = first; u < nbNodes; u += step){
+        for (int v = 0; v < nbNodes; v++){
+            if (isFilled[u*nbNodes + v] == 0){
+                fill(u, v);
+            }
+        }
+    }
+}
+
+/* Computes the paths of every pair not computed yet, the sources being shared among the threads. */
+void PathCache::fillAll(int nbThreads){
+    int nbMissing = nbNodes*nbNodes - getNbEntries();
+    if (nbMissing == 0){
+        return;
+    }
+    if (nbThreads <= 0){
+        nbThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    nbThreads = std::min(nbThreads, nbNodes);
+    if (nbThreads <= 1){
+        fillSources(0, 1);
+    }
+    else{
+        std::vector<std::thread> workers;
+        for (int t = 0; t < nbThreads; t++){
+            workers.emplace_back(&PathCache::fillSources, this, t, nbThreads);
+        }
+        for (unsigned int t = 0; t < workers.size(); t++){
+            workers[t].join();
+        }
+    }
+    nbComputed += nbMissing;
+}
+
+/* Returns the k shortest paths from u to v by increasing length, computing them if needed. */
+const std::vector<PathCache::CachedPath> & PathCache::getPaths(int u, int v){
+    if (isFilled[u*nbNodes + v] == 0){
+        fill(u, v);
+        nbComputed++;
+    }
+    return entries[u*nbNodes + v];
+}
+
+/* Computes the k shortest loopless paths from source to target with Yen's algorithm. */
+void PathCache::computeShortestPaths(int source, int target, std::vector<SearchPath> &paths) const {
+    paths.clear();
+    std::vector<bool> blockedNode(nbNodes, false);
+    std::vector<bool> blockedLink(linkLength.size(), false);
+    SearchPath first;
+    if (source == target || shortestPath(source, target, blockedNode, blockedLink, first) == false){
+        return;
+    }
+    paths.push_back(first);
+
+    /* The candidates found so far, in insertion order: the shortest one is taken next, the first found on ties. */
+    std::vector<SearchPath> candidates;
+    while ((int)paths.size() < nbPaths){
+        const SearchPath previous = paths.back();
+        double rootLength = 0.0;
+        for (unsigned int i = 0; i + 1 < previous.nodes.size(); i++){
+            int spurNode = previous.nodes[i];
+            /* Links leaving the spur node on an accepted path with the same root, and the root nodes, cannot be used. */
+            std::fill(blockedNode.begin(), blockedNode.end(), false);
+            std::fill(blockedLink.begin(), blockedLink.end(), false);
+            for (unsigned int p = 0; p < paths.size(); p++){
+                if (paths[p].nodes.size() > i + 1 && std::equal(previous.nodes.begin(), previous.nodes.begin() + i + 1, paths[p].nodes.begin())){
+                    blockedLink[paths[p].links[i]] = true;
+                }
+            }
+            for (unsigned int j = 0; j < i; j++){
+                blockedNode[previous.nodes[j]] = true;
+            }
+            SearchPath spur;
+            if (shortestPath(spurNode, target, blockedNode, blockedLink, spur)){
+                SearchPath candidate;
+                candidate.nodes.assign(previous.nodes.begin(), previous.nodes.begin() + i);
+                candidate.nodes.insert(candidate.nodes.end(), spur.nodes.begin(), spur.nodes.end());
+                candidate.links.assign(previous.links.begin(), previous.links.begin() + i);
+                candidate.links.insert(candidate.links.end(), spur.links.begin(), spur.links.end());
+                candidate.length = rootLength + spur.length;
+                bool isNew = true;
+                for (unsigned int c = 0; c < candidates.size() && isNew; c++){
+                    isNew = (candidates[c].links != candidate.links);
+                }
+                for (unsigned int p = 0; p < paths.size() && isNew; p++){
+                    isNew = (paths[p].links != candidate.links);
+                }
+                if (isNew){
+                    candidates.push_back(candidate);
+                }
+            }
+            rootLength += linkLength[previous.links[i]];
+        }
+        if (candidates.empty()){
+            return;
+        }
+        unsigned int shortest = 0;
+        for (unsigned int c = 1; c < candidates.size(); c++){
+            if (candidates[c].length < candidates[shortest].length){
+                shortest = c;
+            }
+        }
+        paths.push_back(candidates[shortest]);
+        candidates.erase(candidates.begin() + shortest);
+    }
+}
+
+/* Stores in path the shortest path from source to target avoiding some nodes and links, with Dijkstra's algorithm. */
+bool PathCache::shortestPath(int source, int target, const std::vector<bool> &blockedNode, const std::vector<bool> &blockedLink, SearchPath &path) const {
+    const double INF = std::numeric_limits<double>::infinity();
+    std::vector<double> dist(nbNodes, INF);
+    std::vector<int> predLink(nbNodes, -1);
+    std::vector<int> predNode(nbNodes, -1);
+    typedef std::pair<double, int> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    dist[source] = 0.0;
+    heap.push(Entry(0.0, source));
+    while (!heap.empty()){
+        double nodeDist = heap.top().first;
+        int u = heap.top().second;
+        heap.pop();
+        if (nodeDist > dist[u]){
+            continue;
+        }
+        if (u == target){
+            break;
+        }
+        for (unsigned int k = 0; k < incident[u].size(); k++){
+            int link = incident[u][k].first;
+            int v = incident[u][k].second;
+            if (blockedLink[link] || blockedNode[v]){
+                continue;
+            }
+            double candidate = nodeDist + linkLength[link];
+            if (candidate < dist[v]){
+                dist[v] = candidate;
+                predLink[v] = link;
+                predNode[v] = u;
+                heap.push(Entry(candidate, v));
+            }
+        }
+    }
+    if (dist[target] == INF){
+        return false;
+    }
+    path.nodes.clear();
+    path.links.clear();
+    path.length = dist[target];
+    for (int v = target; v != source; v = predNode[v]){
+        path.nodes.push_back(v);
+        path.links.push_back(predLink[v]);
+    }
+    path.nodes.push_back(source);
+    std::reverse(path.nodes.begin(), path.nodes.end());
+    std::reverse(path.links.begin(), path.links.end());
+    return true;
+}
+
+/*
+* The binary file holds the hash, the number of paths and of nodes, and the number of pairs
+* stored. Each pair is then written as its source, target and number of paths, and each path
+* as its length, number of hops and links.
+*/
+
+/* Loads the binary file of the current topology and returns false if there is none or it does not match. */
+bool PathCache::load(){
+    std::ifstream file(getFileName().c_str(), std::ios::binary);
+    if (!file.is_open()){
+        return false;
+    }
+    unsigned long long hash = 0;
+    int k = 0, n = 0, nbPairs = 0;
+    file.read(reinterpret_cast<char *>(&hash), sizeof(hash));
+    file.read(reinterpret_cast<char *>(&k), sizeof(k));
+    file.read(reinterpret_cast<char *>(&n), sizeof(n));
+    file.read(reinterpret_cast<char *>(&nbPairs), sizeof(nbPairs));
+    if (!file || hash != topologyHash || k != nbPaths || n != nbNodes){
+        std::cerr << "WARNING: Path cache file " << getFileName() << " does not match the topology and is ignored." << std::endl;
+        return false;
+    }
+    std::vector< std::vector<CachedPath> > loaded(nbNodes*nbNodes);
+    std::vector<char> loadedFilled(nbNodes*nbNodes, 0);
+    for (int pair = 0; pair < nbPairs; pair++){
+        int u = -1, v = -1, nb = -1;
+        file.read(reinterpret_cast<char *>(&u), sizeof(u));
+        file.read(reinterpret_cast<char *>(&v), sizeof(v));
+        file.read(reinterpret_cast<char *>(&nb), sizeof(nb));
+        if (!file || u < 0 || u >= nbNodes || v < 0 || v >= nbNodes || nb < 0 || nb > nbPaths){
+            std::cerr << "WARNING: Path cache file " << getFileName() << " is corrupted and is ignored." << std::endl;
+            return false;
+        }
+        std::vector<CachedPath> &entry = loaded[u*nbNodes + v];
+        entry.resize(nb);
+        for (int p = 0; p < nb; p++){
+            file.read(reinterpret_cast<char *>(&entry[p].length), sizeof(entry[p].length));
+            file.read(reinterpret_cast<char *>(&entry[p].nbHops), sizeof(entry[p].nbHops));
+            if (!file || entry[p].nbHops <= 0 || entry[p].nbHops > (int)linkLength.size()){
+                std::cerr << "WARNING: Path cache file " << getFileName() << " is corrupted and is ignored." << std::endl;
+                return false;
+            }
+            entry[p].links.resize(entry[p].nbHops);
+            file.read(reinterpret_cast<char *>(entry[p].links.data()), entry[p].nbHops*sizeof(int));
+            for (int h = 0; h < entry[p].nbHops; h++){
+                if (entry[p].links[h] < 0 || entry[p].links[h] >= (int)linkLength.size()){
+                    std::cerr << "WARNING: Path cache file " << getFileName() << " is corrupted and is ignored." << std::endl;
+                    return false;
+                }
+            }
+        }
+        loadedFilled[u*nbNodes + v] = 1;
+    }
+    if (!file){
+        std::cerr << "WARNING: Path cache file " << getFileName() << " is corrupted and is ignored." << std::endl;
+        return false;
+    }
+    entries.swap(loaded);
+    isFilled.swap(loadedFilled);
+    return true;
+}
+
+/* Saves the cache to the binary file of the current topology, if a folder is given. */
+void PathCache::save() const {
+    if (folder.empty() || isFilled.empty()){
+        return;
+    }
+    std::ofstream file(getFileName().c_str(), std::ios::binary | std::ios::trunc);
+    if (!file.is_open()){
+        std::cerr << "WARNING: Path cache file " << getFileName() << " could not be written." << std::endl;
+        return;
+    }
+    int nbPairs = getNbEntries();
+    file.write(reinterpret_cast<const char *>(&topologyHash), sizeof(topologyHash));
+    file.write(reinterpret_cast<const char *>(&nbPaths), sizeof(nbPaths));
+    file.write(reinterpret_cast<const char *>(&nbNodes), sizeof(nbNodes));
+    file.write(reinterpret_cast<const char *>(&nbPairs), sizeof(nbPairs));
+    for (int u = 0; u < nbNodes; u++){
+        for (int v = 0; v < nbNodes; v++){
+            if (isFilled[u*nbNodes + v] == 0){
+                continue;
+            }
+            const std::vector<CachedPath> &entry = entries[u*nbNodes + v];
+            int nb = (int)entry.size();
+            file.write(reinterpret_cast<const char *>(&u), sizeof(u));
+            file.write(reinterpret_cast<const char *>(&v), sizeof(v));
+            file.write(reinterpret_cast<const char *>(&nb), sizeof(nb));
+            for (int p = 0; p < nb; p++){
+                file.write(reinterpret_cast<const char *>(&entry[p].length), sizeof(entry[p].length));
+                file.write(reinterpret_cast<const char *>(&entry[p].nbHops), sizeof(entry[p].nbHops));
+                file.write(reinterpret_cast<const char *>(entry[p].links.data()), entry[p].nbHops*sizeof(int));
+            }
+        }
+    }
+}
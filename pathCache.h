@@ -0,0 +1,104 @@
+#ifndef __pathCache__h
+#define __pathCache__h
+
+#include <string>
+#include <vector>
+
+#include "Instance.h"
+
+/*********************************************************************************************
+* This class stores the k shortest loopless paths of the physical network for each pair of
+* nodes, so that they are computed once per run instead of once per demand. Paths are computed
+* with Yen's algorithm the first time a pair is searched, or for every pair at once by fillAll.
+* Since all optimizations of a run share the same topology, the cache is kept across them; it
+* is cleared only if the topology changes, which is detected by a hash of the nodes, links and
+* lengths. If a folder is given, the cache is loaded from and saved to a binary file named
+* after this hash.
+* \note Once fillAll has run, searches never write to the cache and may be done by several
+* threads without locks.
+*********************************************************************************************/
+class PathCache {
+
+public:
+    /** A loopless path of the physical network. **/
+    struct CachedPath {
+        double length;              /**< The sum of the link lengths. **/
+        int nbHops;                 /**< The number of links. **/
+        std::vector<int> links;     /**< The link ids, from the source to the target. **/
+    };
+
+private:
+    /** A path with its nodes, as needed by Yen's algorithm. **/
+    struct SearchPath {
+        std::vector<int> nodes;     /**< The node ids, from the source to the target. **/
+        std::vector<int> links;     /**< The link ids, links[i] joining nodes[i] and nodes[i+1]. **/
+        double length;              /**< The sum of the link lengths. **/
+    };
+
+    int nbPaths;                                        /**< The number k of shortest paths stored for each pair. **/
+    std::string folder;                                 /**< The folder of the binary file, empty if the cache is not kept on disk. **/
+    unsigned long long topologyHash;                    /**< The hash of the current topology. **/
+    int nbNodes;                                        /**< The number of nodes of the current topology. **/
+    std::vector<double> linkLength;                     /**< The length of each link. **/
+    std::vector< std::vector< std::pair<int, int> > > incident; /**< incident[u] stores the pairs (link id, other endpoint) of the links incident to node u. **/
+    std::vector< std::vector<CachedPath> > entries;     /**< entries[u*nbNodes + v] stores the paths from u to v by increasing length. **/
+    std::vector<char> isFilled;                         /**< isFilled[u*nbNodes + v] is 1 if the paths from u to v have been computed. **/
+    int nbComputed;                                     /**< How many pairs have been computed rather than loaded. **/
+
+    /** Returns the hash of a topology. @param inst The instance. **/
+    unsigned long long computeHash(const Instance &inst) const;
+
+    /** Returns the path of the binary file of the current topology. **/
+    std::string getFileName() const;
+
+    /** Computes the paths from u to v and stores them. @param u The source node. @param v The target node. **/
+    void fill(int u, int v);
+
+    /** Fills the pairs whose source is congruent to first modulo step. @param first The first source. @param step The step between sources. **/
+    void fillSources(int first, int step);
+
+    /** Computes the k shortest loopless paths from source to target, by increasing length, with Yen's algorithm. @param source The source node. @param target The target node. @param paths Receives the paths. **/
+    void computeShortestPaths(int source, int target, std::vector<SearchPath> &paths) const;
+
+    /** Stores in path the shortest path from source to target avoiding some nodes and links, and returns false if there is none. @param source The source node. @param target The target node. @param blockedNode blockedNode[u] is true if node u cannot be used. @param blockedLink blockedLink[e] is true if link e cannot be used. @param path Receives the path. **/
+    bool shortestPath(int source, int target, const std::vector<bool> &blockedNode, const std::vector<bool> &blockedLink, SearchPath &path) const;
+
+    /** Loads the binary file of the current topology and returns false if there is none or it does not match. **/
+    bool load();
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+    /** Constructor. The cache is empty until a topology is set. @param k The number of shortest paths stored for each pair. @param cacheFolder The folder of the binary file, empty if the cache is not kept on disk. **/
+    PathCache(int k, const std::string &cacheFolder);
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+    /** Returns the number of shortest paths stored for each pair. **/
+    int getNbPaths() const { return nbPaths; }
+
+    /** Returns the number of pairs computed. **/
+    int getNbEntries() const;
+
+    /** Returns how many pairs have been computed rather than loaded. **/
+    int getNbComputed() const { return nbComputed; }
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+    /** Sets the topology of the paths. The cache is kept if the topology is unchanged, and loaded from disk otherwise. @param inst The instance. **/
+    void setTopology(const Instance &inst);
+
+    /** Computes the paths of every pair not computed yet. @param nbThreads The number of threads sharing the pairs. **/
+    void fillAll(int nbThreads);
+
+    /** Returns the k shortest paths from u to v by increasing length, computing them if needed. @param u The source node. @param v The target node. **/
+    const std::vector<CachedPath> & getPaths(int u, int v);
+
+    /** Saves the cache to the binary file of the current topology, if a folder is given. **/
+    void save() const;
+};
+
+#endif
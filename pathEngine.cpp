@@ -0,0 +1,180 @@
+#include "pathEngine.h"
+
+#include <numeric>
+#include <cmath>
+#include <climits>
+
+/* Returns true if the slice window of an arc of the d-th demand is free on its link. */
+bool PathEngine::isWindowFree(int d, const RoutingArc &arc) const {
+    for (int s = arc.slice - demands[d].load + 1; s <= arc.slice; s++){
+        if (s < 0 || isReserved[arc.label][s]){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Routes every demand and returns true if all of them have been routed. */
+bool PathEngine::solve(){
+    isReserved.assign(nbLinks, std::vector<bool>(nbSlices, false));
+    objValue = 0.0;
+    chooseQueue();
+    std::vector<int> order(getNbDemands());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int d1, int d2){ return demands[d1].load > demands[d2].load; });
+    for (unsigned int k = 0; k < order.size(); k++){
+        if (route(order[k]) == false){
+            std::cout << "Demand " << demands[order[k]].id + 1 << " could not be routed." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Routes the d-th demand on its cheapest slice layer, reserves its slice window and returns false if it cannot be routed. */
+bool PathEngine::route(int d){
+    const RoutingDemand &demand = demands[d];
+    outArcs.assign(nbNodes*nbSlices, std::vector<int>());
+    for (unsigned int i = 0; i < demand.arcs.size(); i++){
+        const RoutingArc &arc = demand.arcs[i];
+        if (arc.isAvailable && isWindowFree(d, arc)){
+            outArcs[arc.tail*nbSlices + arc.slice].push_back(i);
+        }
+    }
+
+    /* Keep the cheapest path among all layers, and the lowest slice on ties. */
+    double bestCost = 0.0;
+    std::vector<int> bestPath;
+    for (int slice = demand.load - 1; slice < nbSlices; slice++){
+        int last = shortestPath(d, slice);
+        if (last != -1 && (bestPath.empty() || labels[last].cost < bestCost - EPSILON)){
+            bestCost = labels[last].cost;
+            bestPath.clear();
+            for (int l = last; labels[l].predecessor != -1; l = labels[l].predecessor){
+                bestPath.push_back(labels[l].arc);
+            }
+        }
+    }
+    if (bestPath.empty()){
+        return false;
+    }
+    for (unsigned int k = 0; k < bestPath.size(); k++){
+        const RoutingArc &arc = demand.arcs[bestPath[k]];
+        onPath[d][bestPath[k]] = true;
+        for (int s = arc.slice - demand.load + 1; s <= arc.slice; s++){
+            isReserved[arc.label][s] = true;
+        }
+    }
+    objValue += bestCost;
+    return true;
+}
+
+/* Chooses the priority queue according to the arc costs of the model. */
+void PathEngine::chooseQueue(){
+    bool isIntegral = true;
+    maxArcCost = 0;
+    for (int d = 0; d < getNbDemands() && isIntegral; d++){
+        for (unsigned int i = 0; i < demands[d].arcs.size(); i++){
+            double cost = demands[d].arcs[i].cost;
+            if (cost < 0 || std::fabs(cost - std::round(cost)) > EPSILON){
+                isIntegral = false;
+                break;
+            }
+            maxArcCost = std::max(maxArcCost, (int)std::min(std::round(cost), (double)INT_MAX - 1));
+        }
+    }
+    if (isIntegral == false){
+        queueType = BINARY_HEAP;
+        std::cout << "> Labels are settled with a binary heap." << std::endl;
+    }
+    else if (maxArcCost <= MAX_DIAL_COST){
+        queueType = DIAL_BUCKETS;
+        std::cout << "> Labels are settled with Dial's buckets (largest arc cost: " << maxArcCost << ")." << std::endl;
+    }
+    else{
+        queueType = RADIX_HEAP;
+        std::cout << "> Labels are settled with a radix heap (largest arc cost: " << maxArcCost << ")." << std::endl;
+    }
+}
+
+/* Searches for the cheapest path of the d-th demand on one slice layer respecting its maximal length, with the chosen priority queue. */
+int PathEngine::shortestPath(int d, int slice){
+    switch (queueType){
+        case DIAL_BUCKETS:
+        {
+            DialQueue queue(maxArcCost);
+            return shortestPath(d, slice, queue);
+        }
+        case RADIX_HEAP:
+        {
+            RadixHeap queue;
+            return shortestPath(d, slice, queue);
+        }
+        default:
+        {
+            BinaryHeapQueue queue;
+            return shortestPath(d, slice, queue);
+        }
+    }
+}
+
+/* Searches for the cheapest path of the d-th demand on one slice layer respecting its maximal length. */
+template <class Queue>
+int PathEngine::shortestPath(int d, int slice, Queue &queue){
+    const RoutingDemand &demand = demands[d];
+    labels.clear();
+    nodeLabels.assign(nbNodes, std::vector<int>());
+
+    /* Labels are settled by increasing cost: the first one reaching the target is the cheapest feasible path. */
+    PathLabel start = {demand.source, 0.0, 0.0, -1, -1, false};
+    addLabel(start);
+    queue.push(0.0, 0);
+    while (!queue.empty()){
+        int current = queue.pop();
+        if (labels[current].isDominated){
+            continue;
+        }
+        int node = labels[current].node;
+        if (node == demand.target){
+            return current;
+        }
+        const std::vector<int> &arcs = outArcs[node*nbSlices + slice];
+        for (unsigned int k = 0; k < arcs.size(); k++){
+            const RoutingArc &arc = demand.arcs[arcs[k]];
+            /* Nothing leaves the target and nothing enters the source. */
+            if (arc.head == demand.source){
+                continue;
+            }
+            PathLabel next = {arc.head, labels[current].cost + arc.cost, labels[current].length + arc.length, current, arcs[k], false};
+            if (next.length <= demand.maxLength + EPSILON && addLabel(next)){
+                queue.push(next.cost, (int)labels.size() - 1);
+            }
+        }
+    }
+    return -1;
+}
+
+/* Adds a label to the search unless it is dominated, and returns true if it has been added. */
+bool PathEngine::addLabel(const PathLabel &label){
+    std::vector<int> &current = nodeLabels[label.node];
+    for (unsigned int k = 0; k < current.size(); k++){
+        const PathLabel &other = labels[current[k]];
+        if (other.cost <= label.cost + EPSILON && other.length <= label.length + EPSILON){
+            return false;
+        }
+    }
+    std::vector<int> kept;
+    for (unsigned int k = 0; k < current.size(); k++){
+        PathLabel &other = labels[current[k]];
+        if (label.cost <= other.cost + EPSILON && label.length <= other.length + EPSILON){
+            other.isDominated = true;
+        }
+        else{
+            kept.push_back(current[k]);
+        }
+    }
+    labels.push_back(label);
+    kept.push_back((int)labels.size() - 1);
+    current.swap(kept);
+    return true;
+}
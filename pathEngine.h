@@ -0,0 +1,93 @@
+#ifndef __pathEngine__h
+#define __pathEngine__h
+
+#include "routingBackend.h"
+#include "bucketQueue.h"
+
+/*********************************************************************************************
+* This structure stores a label of the resource-constrained shortest path search: a partial
+* path from the source of a slice layer to a node, with its cost and its length.
+*********************************************************************************************/
+struct PathLabel {
+    int node;           /**< The label of the node reached by the partial path. **/
+    double cost;        /**< The cost of the partial path. **/
+    double length;      /**< The length of the partial path. **/
+    int predecessor;    /**< The index of the label from which this one has been extended (-1 at the source). **/
+    int arc;            /**< The index of the arc used to extend the predecessor (-1 at the source). **/
+    bool isDominated;   /**< True if another label reaching the same node is at least as cheap and as short. **/
+};
+
+/*********************************************************************************************
+* This class is an embedded RoutingBackend that needs no external solver. Demands are routed
+* one at a time, in decreasing load order. For each demand, every slice layer of its extended
+* graph is searched with a label-setting algorithm for the cheapest path respecting the maximal
+* length, using only arcs whose slice window is still free on their link. The cheapest path
+* among all layers is kept and its window is reserved on every link it uses before the next
+* demand is routed.
+* The labels are settled with Dial's buckets when every arc cost is a small integer (metrics
+* 1, 1p, 2 and 8), with a radix heap when costs are larger integers (e.g., integral lengths
+* under metric 4), and with a binary heap otherwise.
+* \note The solution is optimal when a single demand is routed at a time. For several demands,
+* it is a feasible solution of the model, not necessarily an optimal one.
+*********************************************************************************************/
+class PathEngine : public RoutingBackend {
+
+private:
+    const double EPSILON = 0.000001;
+    const int MAX_DIAL_COST = 4096;     /**< The largest arc cost for which Dial's buckets are used. **/
+
+    /** The priority queues available for settling labels. **/
+    enum QueueType {
+        BINARY_HEAP = 0,    /**< Arc costs are not all integral. **/
+        DIAL_BUCKETS = 1,   /**< Arc costs are integers not larger than MAX_DIAL_COST. **/
+        RADIX_HEAP = 2      /**< Arc costs are larger integers. **/
+    };
+
+    QueueType queueType;                            /**< The priority queue chosen for the arc costs of the model. **/
+    int maxArcCost;                                 /**< The largest arc cost of the model, rounded up. **/
+
+    std::vector< std::vector<bool> > isReserved;    /**< isReserved[label][slice] is true if the slice has been assigned on the link to a demand routed earlier in this model. **/
+    std::vector< std::vector<int> > outArcs;        /**< outArcs[tail*nbSlices + slice] stores the arcs of the current demand leaving node tail on the given slice layer. **/
+    std::vector<PathLabel> labels;                  /**< Every label created in the current search. **/
+    std::vector< std::vector<int> > nodeLabels;     /**< nodeLabels[node] stores the non-dominated labels reaching a node in the current search. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Creates an empty model. **/
+    PathEngine() : RoutingBackend(), queueType(BINARY_HEAP), maxArcCost(0) {}
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+	/** Returns the name of the backend. **/
+    std::string getName() const { return "embedded path engine"; }
+
+	/** Returns true if the slice window of an arc of the d-th demand is free on its link. @param d The demand index. @param arc The arc. **/
+    bool isWindowFree(int d, const RoutingArc &arc) const;
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+	/** Routes every demand and returns true if all of them have been routed. **/
+    bool solve();
+
+	/** Routes the d-th demand on its cheapest slice layer, reserves its slice window and returns false if it cannot be routed. @param d The demand index. **/
+    bool route(int d);
+
+	/** Chooses the priority queue according to the arc costs of the model. **/
+    void chooseQueue();
+
+	/** Searches for the cheapest path of the d-th demand on one slice layer respecting its maximal length, with the chosen priority queue. Returns the index of the label reaching the target, or -1 if none exists. @param d The demand index. @param slice The slice layer. **/
+    int shortestPath(int d, int slice);
+
+	/** Searches for the cheapest path of the d-th demand on one slice layer respecting its maximal length. Returns the index of the label reaching the target, or -1 if none exists. @param d The demand index. @param slice The slice layer. @param queue An empty priority queue. **/
+    template <class Queue>
+    int shortestPath(int d, int slice, Queue &queue);
+
+	/** Adds a label to the search unless it is dominated, and returns true if it has been added. @param label The label to be added. **/
+    bool addLabel(const PathLabel &label);
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include "routingBackend.h"
+
+/* Adds a demand to the model and returns its index. */
+int RoutingBackend::addDemand(int id, int source, int target, int load, double maxLength, int symmetricPredecessor){
+    RoutingDemand demand;
+    demand.id = id;
+    demand.source = source;
+    demand.target = target;
+    demand.load = load;
+    demand.maxLength = maxLength;
+    demand.symmetricPredecessor = symmetricPredecessor;
+    demands.push_back(demand);
+    onPath.push_back(std::vector<bool>());
+    nbNodes = std::max(nbNodes, std::max(source, target) + 1);
+    return (int)demands.size() - 1;
+}
+
+/* Adds an arc to the extended graph of the d-th demand and returns its index. */
+int RoutingBackend::addArc(int d, const RoutingArc &arc){
+    demands[d].arcs.push_back(arc);
+    onPath[d].push_back(false);
+    nbNodes = std::max(nbNodes, std::max(arc.tail, arc.head) + 1);
+    nbLinks = std::max(nbLinks, arc.label + 1);
+    nbSlices = std::max(nbSlices, arc.slice + 1);
+    return (int)demands[d].arcs.size() - 1;
+}
@@ -0,0 +1,96 @@
+#ifndef __routingBackend__h
+#define __routingBackend__h
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+/*********************************************************************************************
+* This structure describes an arc of the extended graph associated with a demand: a link used
+* on a given slice position between two nodes of the topology.
+*********************************************************************************************/
+struct RoutingArc {
+    int tail;           /**< The label of the node from which the arc leaves. **/
+    int head;           /**< The label of the node the arc enters. **/
+    int label;          /**< The label of the link. **/
+    int slice;          /**< The last slice position assigned to the demand if the arc is used. **/
+    double cost;        /**< The coefficient of the arc according to the chosen metric. **/
+    double length;      /**< The physical length of the link. **/
+    bool isAvailable;   /**< False if the arc cannot be used (i.e., its variable is fixed to 0). **/
+};
+
+/*********************************************************************************************
+* This structure describes a demand to be routed and the arcs of its extended graph.
+*********************************************************************************************/
+struct RoutingDemand {
+    int id;                         /**< The demand's id. **/
+    int source;                     /**< The demand's source node label. **/
+    int target;                     /**< The demand's target node label. **/
+    int load;                       /**< The number of consecutive slices required. **/
+    double maxLength;               /**< The maximal length allowed for the path. **/
+    int symmetricPredecessor;       /**< The index of the last demand before this one with the same source, target, load and maximal length, or -1 if there is none. **/
+    std::vector<RoutingArc> arcs;   /**< The arcs of the demand's extended graph. **/
+};
+
+/*********************************************************************************************
+* This class is the backend-neutral description of the Online Routing and Spectrum Allocation
+* model. A demand must be routed on one slice layer of its extended graph, from its source to
+* its target, within its maximal length, and the slice windows of two demands must not overlap
+* on a link. The model is filled by Solver through addDemand/addArc and solved by a derived
+* backend. The solution is reported as one boolean per arc.
+* \note This class and its derived backends do not depend on CPLEX or LEMON, unless stated
+* otherwise.
+*********************************************************************************************/
+class RoutingBackend {
+
+protected:
+    std::vector<RoutingDemand> demands;             /**< The demands to be routed. **/
+    std::vector< std::vector<bool> > onPath;        /**< onPath[d][i] is true if the i-th arc of the d-th demand is used in the solution. **/
+    double objValue;                                /**< The objective value of the solution found. **/
+    int nbNodes;                                    /**< The number of node labels in the model. **/
+    int nbLinks;                                    /**< The number of link labels in the model. **/
+    int nbSlices;                                   /**< The number of slice positions in the model. **/
+
+public:
+	/****************************************************************************************/
+	/*										Constructors									*/
+	/****************************************************************************************/
+	/** Constructor. Creates an empty model. **/
+    RoutingBackend() : objValue(0.0), nbNodes(0), nbLinks(0), nbSlices(0) {}
+
+	/** Destructor. **/
+    virtual ~RoutingBackend() {}
+
+	/****************************************************************************************/
+	/*										Getters											*/
+	/****************************************************************************************/
+	/** Returns the name of the backend. **/
+    virtual std::string getName() const = 0;
+
+	/** Returns the number of demands in the model. **/
+    int getNbDemands() const { return (int)demands.size(); }
+
+	/** Returns the d-th demand of the model. @param d The demand index. **/
+    const RoutingDemand & getDemand(int d) const { return demands[d]; }
+
+	/** Returns true if the i-th arc of the d-th demand is used in the solution. @param d The demand index. @param i The arc index. **/
+    bool isOnPath(int d, int i) const { return onPath[d][i]; }
+
+	/** Returns the objective value of the solution found. **/
+    double getObjValue() const { return objValue; }
+
+	/****************************************************************************************/
+	/*										Methods											*/
+	/****************************************************************************************/
+	/** Adds a demand to the model and returns its index. @param id The demand's id. @param source The source label. @param target The target label. @param load The demand's load. @param maxLength The maximal length. @param symmetricPredecessor The index of the previous identical demand, or -1 if there is none. **/
+    int addDemand(int id, int source, int target, int load, double maxLength, int symmetricPredecessor = -1);
+
+	/** Adds an arc to the extended graph of the d-th demand and returns its index. @param d The demand index. @param arc The arc. **/
+    int addArc(int d, const RoutingArc &arc);
+
+	/** Solves the model and returns true if every demand has been routed. **/
+    virtual bool solve() = 0;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#include "rowBlock.h"
+
+/* Appends every row of another block at the end of this one. */
+void RowBlock::append(const RowBlock &block){
+    int shift = (int)rmatind.size();
+    for (int i = 0; i < block.getNbRows(); i++){
+        rmatbeg.push_back(block.rmatbeg[i] + shift);
+    }
+    rhs.insert(rhs.end(), block.rhs.begin(), block.rhs.end());
+    sense.insert(sense.end(), block.sense.begin(), block.sense.end());
+    rmatind.insert(rmatind.end(), block.rmatind.begin(), block.rmatind.end());
+    rmatval.insert(rmatval.end(), block.rmatval.begin(), block.rmatval.end());
+    name.insert(name.end(), block.name.begin(), block.name.end());
+}
@@ -0,0 +1,33 @@
+#ifndef __rowBlock__h
+#define __rowBlock__h
+
+#include <vector>
+#include <string>
+
+/*********************************************************************************************
+* This structure stores a block of linear constraints in compressed sparse row format, as
+* expected by CPXaddrows. Row i has coefficients rmatval[rmatbeg[i] .. rmatbeg[i+1]-1] on
+* columns rmatind[rmatbeg[i] .. rmatbeg[i+1]-1].
+*********************************************************************************************/
+struct RowBlock {
+	std::vector<double> rhs;		/**< The right-hand side of each row. **/
+	std::vector<char> sense;		/**< The sense of each row ('L', 'E' or 'G'). **/
+	std::vector<int> rmatbeg;		/**< The position in rmatind/rmatval where each row starts. **/
+	std::vector<int> rmatind;		/**< The column index of each nonzero coefficient. **/
+	std::vector<double> rmatval;	/**< The value of each nonzero coefficient. **/
+	std::vector<std::string> name;	/**< The name of each row. @note Left empty if names are not required. **/
+
+	/** Returns the number of rows in the block. **/
+	int getNbRows() const { return (int)rhs.size(); }
+
+	/** Opens a new row. Coefficients are then appended with addCoeff. @param s The row sense. @param r The right-hand side. **/
+	void newRow(char s, double r) { rmatbeg.push_back((int)rmatind.size()); sense.push_back(s); rhs.push_back(r); }
+
+	/** Appends a coefficient to the last opened row. @param col The column index. @param val The coefficient. **/
+	void addCoeff(int col, double val) { rmatind.push_back(col); rmatval.push_back(val); }
+
+	/** Appends every row of another block at the end of this one. @param block The block to be appended. **/
+	void append(const RowBlock &block);
+};
+
+#endif
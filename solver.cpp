@@ -5,6 +5,13 @@ Solver::Solver(const Instance &inst) : RSA(inst) {
     std::cout << "--- Solver has been initalized ---" << std::endl;
     for (int d = 0; d < getNbDemandsToBeRouted(); d++){ 
         vecArcIndex.emplace_back(new ArcMap((*vecGraph[d]), -1));
+    }
+    setArcIndices();
+}
+
+/* Numbers the arcs of each graph from 0. */
+void Solver::setArcIndices(){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){ 
         int index=0;
         for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
             setArcIndex(a, d, index);
@@ -13,6 +20,64 @@ Solver::Solver(const Instance &inst) : RSA(inst) {
     }
 }
 
+/* Erases from each graph the arcs that cannot belong to a solution better than a known one, and numbers the remaining arcs again. */
+void Solver::eraseFixedArcs(const std::vector< std::set<ArcKey> > &fixedArcs){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        int nb = eraseArcs(d, fixedArcs[d]);
+        std::cout << "> Number of arcs fixed to zero on graph #" << d << ": " << nb << " (" << countArcs(*vecGraph[d]) << " left)" << std::endl;
+    }
+    setArcIndices();
+}
+
+/* Writes every demand to be routed and the arcs of its graph into a backend-neutral model. */
+void Solver::buildRoutingModel(RoutingBackend &backend){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const Demand demand = getToBeRouted_k(d);
+        int index = backend.addDemand(demand.getId(), demand.getSource(), demand.getTarget(), demand.getLoad(), demand.getMaxLength(), getSymmetricPredecessor(d));
+        std::vector<RoutingArc> arcs(countArcs(*vecGraph[d]));
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            RoutingArc &arc = arcs[getArcIndex(a, d)];
+            arc.tail = getNodeLabel((*vecGraph[d]).source(a), d);
+            arc.head = getNodeLabel((*vecGraph[d]).target(a), d);
+            arc.label = getArcLabel(a, d);
+            arc.slice = getArcSlice(a, d);
+            arc.cost = getCoeff(a, d);
+            arc.length = getArcLength(a, d);
+            arc.isAvailable = instance.hasEnoughSpace(arc.label, arc.slice, demand);
+        }
+        for (unsigned int i = 0; i < arcs.size(); i++){
+            backend.addArc(index, arcs[i]);
+        }
+    }
+}
+
+/* Solves the routing model with the given backend and stores the obtained paths on vecOnPath. */
+bool Solver::solve(RoutingBackend &backend){
+    std::cout << "--- " << backend.getName() << " has been chosen ---" << std::endl;
+    buildRoutingModel(backend);
+    std::cout << "Routing model has been defined..." << std::endl;
+    std::cout << "Solving..." << std::endl;
+    if (backend.solve() == false){
+        std::cout << "Could not find a path!" << std::endl;
+        return false;
+    }
+    std::cout << "Solved!" << std::endl;
+    std::cout << "Objective Function Value: " << backend.getObjValue() << std::endl;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            if (backend.isOnPath(d, getArcIndex(a, d))){
+                (*vecOnPath[d])[a] = getToBeRouted_k(d).getId();
+            }
+            else{
+                (*vecOnPath[d])[a] = -1;
+            }
+        }
+    }
+    displayPaths();
+    return true;
+}
+
+#ifndef NO_CPLEX
 /* Define variables x[a][d] for every arc a in the extedend graph and every demand d to be routed. */
 void Solver::setVariables(IloNumVarMatrix &var, IloModel &mod){
     for (int d = 0; d < getNbDemandsToBeRouted(); d++){ 
@@ -221,4 +286,37 @@ IloRange Solver::getNonOverlappingConstraint(IloNumVarMatrix &var, IloModel &mod
     return constraint;
 }
 
+/* Symmetry-breaking constraints. Identical demands leave their source in increasing slice order */
+void Solver::setSymmetryBreakingConstraints(IloNumVarMatrix &var, IloModel &mod){
+    for (int d2 = 0; d2 < getNbDemandsToBeRouted(); d2++){
+        int d1 = getSymmetricPredecessor(d2);
+        if (d1 != -1){
+            IloRange symmetry = getSymmetryBreakingConstraint(var, mod, d1, d2);
+            mod.add(symmetry);
+        }
+    }
+}
 
+/* Get an specific Symmetry-Breaking constraint. The slice of the arc leaving the source of demand d1 is not larger than the one of demand d2. */
+IloRange Solver::getSymmetryBreakingConstraint(IloNumVarMatrix &var, IloModel &mod, int d1, int d2){
+    IloExpr exp(mod.getEnv());
+    IloNum rhs = 0;
+    for (ListDigraph::ArcIt a(*vecGraph[d1]); a != INVALID; ++a){
+        if (getNodeLabel((*vecGraph[d1]).source(a), d1) == getToBeRouted_k(d1).getSource()){
+            int id = getArcIndex(a, d1);
+            exp += getArcSlice(a, d1)*var[d1][id];
+        }
+    }
+    for (ListDigraph::ArcIt a(*vecGraph[d2]); a != INVALID; ++a){
+        if (getNodeLabel((*vecGraph[d2]).source(a), d2) == getToBeRouted_k(d2).getSource()){
+            int id = getArcIndex(a, d2);
+            exp += (-1)*getArcSlice(a, d2)*var[d2][id];
+        }
+    }
+    std::ostringstream constraintName;
+    constraintName << "Symmetry(" << getToBeRouted_k(d1).getId()+1 << "," << getToBeRouted_k(d2).getId()+1 << ")";
+    IloRange constraint(mod.getEnv(), -IloInfinity, exp, rhs, constraintName.str().c_str());
+    exp.end();
+    return constraint;
+}
+#endif
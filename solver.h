@@ -2,9 +2,13 @@
 #define __solver__h
 
 #include "RSA.h"
+#include "routingBackend.h"
 
+#ifndef NO_CPLEX
+#include <ilcplex/ilocplex.h>
 
 typedef IloArray<IloNumVarArray> IloNumVarMatrix;
+#endif
 
 
 class Solver : public RSA{
@@ -22,12 +26,15 @@ public:
 	/************************************************/
     int getArcIndex(const ListDigraph::Arc &a, int d) const { return (*vecArcIndex[d])[a]; }
 
+#ifndef NO_CPLEX
     IloExpr getObjFunction(IloNumVarMatrix &var, IloModel &mod);
     IloRange getSourceConstraint_d(IloNumVarMatrix &var, IloModel &mod, const Demand & demand, int d, int i);
     IloRange getFlowConservationConstraint_i_d(IloNumVarMatrix &var, IloModel &mod, ListDigraph::Node &v, const Demand & demand, int d);
     IloRange getTargetConstraint_d(IloNumVarMatrix &var, IloModel &mod, const Demand & demand, int d);
     IloRange getLengthConstraint(IloNumVarMatrix &var, IloModel &mod, const Demand &demand, int d);
     IloRange getNonOverlappingConstraint(IloNumVarMatrix &var, IloModel &mod, int linkLabel, int slice, const Demand & demand1, int d1, const Demand & demand2, int d2);
+    IloRange getSymmetryBreakingConstraint(IloNumVarMatrix &var, IloModel &mod, int d1, int d2);
+#endif
     
 	/************************************************/
 	/*					   Setters 		    		*/
@@ -35,6 +42,23 @@ public:
 
 	void setArcIndex(const ListDigraph::Arc &a, int d, int val) { (*vecArcIndex[d])[a] = val; }
 
+	/************************************************/
+	/*					   Methods 		    		*/
+	/************************************************/
+
+	/* Numbers the arcs of each graph from 0. */
+    void setArcIndices();
+
+	/* Erases from graph #d the arcs of fixedArcs[d], which cannot belong to a solution better than a known one, and numbers the remaining arcs again. */
+    void eraseFixedArcs(const std::vector< std::set<ArcKey> > &fixedArcs);
+
+	/* Writes every demand to be routed and the arcs of its graph into a backend-neutral model. The i-th arc of demand d is the arc with index i on graph #d. */
+    void buildRoutingModel(RoutingBackend &backend);
+
+	/* Solves the routing model with the given backend and stores the obtained paths on vecOnPath. Returns true if every demand has been routed. */
+    bool solve(RoutingBackend &backend);
+
+#ifndef NO_CPLEX
 	/* Define variables x[a][d] for every arc a in the extedend graph and every demand d to be routed. */
     void setVariables(IloNumVarMatrix &var, IloModel &mod);
 
@@ -54,5 +78,9 @@ public:
 
 	/* Non-Overlapping constraints. Demands must not overlap eachother's slices */
     void setNonOverlappingConstraints(IloNumVarMatrix &var, IloModel &mod);
+
+	/* Symmetry-breaking constraints. Identical demands leave their source in increasing slice order */
+    void setSymmetryBreakingConstraints(IloNumVarMatrix &var, IloModel &mod);
+#endif
 };    
 #endif
\ No newline at end of file
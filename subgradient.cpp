@@ -1,21 +1,42 @@
 #include "subgradient.h"
 
+#include <cmath>
+#include <thread>
+#include <numeric>
+#include <queue>
+#include <algorithm>
+
+
+Subgradient::Subgradient(const Instance &inst, MultiplierCache *multiplierCache) : RSA(inst),
+        MAX_NB_IT_WITHOUT_IMPROVEMENT(inst.getInput().getNbIterationsWithoutImprovement()),
+        MAX_NB_IT(inst.getInput().getMaxNbIterations()), NB_THREADS(inst.getInput().getNbThreads()),
+        MULTIPLIER_UPDATE(inst.getInput().getChosenMultiplierUpdate()), TARGET_GAP(inst.getInput().getTargetGap()),
+        shared(NULL), startId(0), cache(multiplierCache) {
+
 
-Subgradient::Subgradient(const Instance &inst) : RSA(inst), 
-        SOURCE(getToBeRouted()[0].getSource()), TARGET(getToBeRouted()[0].getTarget()), 
-        MAX_LENGTH(getToBeRouted()[0].getMaxLength()), 
-        MAX_NB_IT_WITHOUT_IMPROVEMENT(inst.getInput().getNbIterationsWithoutImprovement()), 
-        MAX_NB_IT(inst.getInput().getMaxNbIterations()), cost(*vecGraph[0]) {
-    
-    
     std::cout << "--- Subgradient was invoked ---" << std::endl;
-    std::cout << "> Route demand " << SOURCE+1 << "->" << TARGET+1 << std::endl;
-    std::cout << "> Max Length: " << MAX_LENGTH << std::endl << std::endl;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        std::cout << "> Route demand " << getToBeRouted_k(d).getSource()+1 << "->" << getToBeRouted_k(d).getTarget()+1;
+        std::cout << " (Max Length: " << getToBeRouted_k(d).getMaxLength() << ")" << std::endl;
+    }
+    std::cout << std::endl;
 
     initialization();
     std::cout << "> Subgradient was initialized. " << std::endl;
 
-    run(getFirstNodeFromLabel(0, SOURCE), getFirstNodeFromLabel(0, TARGET));
+    run();
+
+}
+
+/* Constructor of trajectory #start of a multi-start run. The trajectory is run by the caller. */
+Subgradient::Subgradient(const Instance &inst, SharedBounds *sharedBounds, int start) : RSA(inst),
+        MAX_NB_IT_WITHOUT_IMPROVEMENT(inst.getInput().getNbIterationsWithoutImprovement()),
+        MAX_NB_IT(inst.getInput().getMaxNbIterations()), NB_THREADS(1),
+        MULTIPLIER_UPDATE(inst.getInput().getChosenMultiplierUpdate()), TARGET_GAP(inst.getInput().getTargetGap()),
+        shared(sharedBounds), startId(start), cache(NULL) {
+
+    initialization();
+    std::cout << "> Trajectory #" << startId+1 << " was initialized (lambda = " << getLambda() << ")." << std::endl;
 
 }
 
@@ -25,175 +46,774 @@ void Subgradient::initialization(){
     setItWithoutImprovement(0);
     setLB(-__DBL_MAX__);
     setUB(__DBL_MAX__);
+    setIsFeasible(false);
     setIsOptimal(false);
+    setStepSize(0.0);
+    startTime = std::chrono::high_resolution_clock::now();
+    nbShortestPaths = 0;
+    itToGap = -1;
+    timeToGap = 0.0;
+    nbShortestPathsToGap = 0;
+    direction.clear();
+    center.clear();
+    aggregate.clear();
+    bundle.clear();
+    bundleError.clear();
+    centerValue = -__DBL_MAX__;
+    aggregateError = 0.0;
+    proximalParameter = 0.0;
+    predictedIncrease = __DBL_MAX__;
+
+    nbSlices = 0;
+    for (int i = 0; i < instance.getNbEdges(); i++){
+        nbSlices = std::max(nbSlices, instance.getPhysicalLinkFromId(i).getNbSlices());
+    }
 
     double initialMultiplier = instance.getInput().getInitialLagrangianMultiplier();
-    lagrangianMultiplier.push_back(initialMultiplier);
-    std::cout << "> Initial lagrangian multiplier was defined. " << std::endl;
+    lengthMultiplier.assign(getNbDemandsToBeRouted(), initialMultiplier);
+    bestLengthMultiplier = lengthMultiplier;
+    /* Trajectory #t of a multi-start run starts its overlap multipliers at t times the initial multiplier. */
+    overlapMultiplier.assign(instance.getNbEdges()*nbSlices, startId*initialMultiplier);
+    bestOverlapMultiplier = overlapMultiplier;
+    lengthSlack.assign(getNbDemandsToBeRouted(), 0.0);
+    overlapSlack.assign(instance.getNbEdges()*nbSlices, 1.0);
+    std::cout << "> Initial lagrangian multipliers were defined. " << std::endl;
 
     subgradientPreprocessing();
-    updateCosts();
+    vecPath.resize(getNbDemandsToBeRouted());
+    pathDist.assign(getNbDemandsToBeRouted(), 0.0);
+    updateOverlapPrefix();
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        vecPrimal.emplace_back(new ArcCost(*vecGraph[d], 0.0));
+        buildArcArrays(d);
+        updateCosts(d);
+    }
+    buildDeltaStepping();
 
+    /* Trajectory #t of a multi-start run starts with lambda halved t times. */
     double initialLambda = instance.getInput().getInitialLagrangianLambda();
-    lambda.push_back(initialLambda);
+    setLambda(std::ldexp(initialLambda, -startId));
     std::cout << "> Initial lambda was defined. " << std::endl;
 
 }
 
-/* Call preprocessing methods. */
+/* Call preprocessing methods. Each search then runs once from the virtual source of a graph instead of once per slice. */
 void Subgradient::subgradientPreprocessing(){
-    contractNodesFromLabel(0, SOURCE);
-    contractNodesFromLabel(0, TARGET);
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        addVirtualTerminals(d);
+        vecSource.push_back(getVirtualSource(d));
+        vecTarget.push_back(getVirtualTarget(d));
+    }
 }
 
-/* Updates the arc costs according to the last lagrangian multiplier available. cost = c + u_k*length */
-void Subgradient::updateCosts(){
-    for (ListDigraph::ArcIt a(*vecGraph[0]); a != INVALID; ++a){
-        double arcCost = getCoeff(a, 0);
-        cost[a] = arcCost + ( getLastMultiplier()*getArcLength(a, 0) );
+/* Fills the flat arc arrays of graph #d, reading the coefficients computed once by RSA. Virtual arcs keep null costs, lengths and windows. */
+void Subgradient::buildArcArrays(int d){
+    const int load = getToBeRouted_k(d).getLoad();
+    const int nbArcs = (*vecGraph[d]).maxArcId() + 1;
+    vecFlatBaseCost.emplace_back(nbArcs, 0.0);
+    vecFlatLength.emplace_back(nbArcs, 0.0);
+    vecFlatWindowBegin.emplace_back(nbArcs, 0);
+    vecFlatWindowEnd.emplace_back(nbArcs, 0);
+    vecFlatCost.emplace_back(nbArcs, 0.0);
+    vecFlatTail.emplace_back(nbArcs, 0);
+    vecFlatHead.emplace_back(nbArcs, 0);
+    vecFlatReducedCost.emplace_back(nbArcs, 0.0);
+    minBaseCost.push_back(__DBL_MAX__);
+    for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+        int id = ListDigraph::id(a);
+        vecFlatTail[d][id] = getNodeLabel((*vecGraph[d]).source(a), d);
+        vecFlatHead[d][id] = getNodeLabel((*vecGraph[d]).target(a), d);
+        if (isVirtualArc(a, d)){
+            continue;
+        }
+        int label = getArcLabel(a, d);
+        int slice = getArcSlice(a, d);
+        vecFlatBaseCost[d][id] = getCoeff(a, d);
+        vecFlatLength[d][id] = getArcLength(a, d);
+        vecFlatWindowBegin[d][id] = label*(nbSlices + 1) + std::max(0, slice - load + 1);
+        vecFlatWindowEnd[d][id] = label*(nbSlices + 1) + slice + 1;
+        minBaseCost[d] = std::min(minBaseCost[d], vecFlatBaseCost[d][id]);
+    }
+    if (minBaseCost[d] == __DBL_MAX__ || minBaseCost[d] < 0.0){
+        minBaseCost[d] = 0.0;
     }
 }
 
-/* Solves the Constrained Shortest Path from node s to node t using the Subgradient Method. */
-void Subgradient::run(const ListDigraph::Node &s, const ListDigraph::Node &t){
+/* Updates the prefix sums of the overlap multipliers of each link. */
+void Subgradient::updateOverlapPrefix(){
+    overlapPrefix.assign(instance.getNbEdges()*(nbSlices + 1), 0.0);
+    for (int label = 0; label < instance.getNbEdges(); label++){
+        for (int s = 0; s < nbSlices; s++){
+            overlapPrefix[label*(nbSlices + 1) + s + 1] = overlapPrefix[label*(nbSlices + 1) + s] + overlapMultiplier[label*nbSlices + s];
+        }
+    }
+}
+
+/* Updates the arc costs of graph #d according to the current multipliers. cost = c + u[d]*length + sum of v over the slices covered by the arc */
+void Subgradient::updateCosts(int d){
+    const int nbArcs = vecFlatCost[d].size();
+    const double multiplier = getLengthMultiplier_d(d);
+    const double *baseCost = vecFlatBaseCost[d].data();
+    const double *length = vecFlatLength[d].data();
+    const int *windowBegin = vecFlatWindowBegin[d].data();
+    const int *windowEnd = vecFlatWindowEnd[d].data();
+    const double *prefix = overlapPrefix.data();
+    double *cost = vecFlatCost[d].data();
+    /* A plain axpy the compiler vectorizes, then the window sums as differences of prefix sums. */
+    for (int i = 0; i < nbArcs; i++){
+        cost[i] = baseCost[i] + multiplier*length[i];
+    }
+    for (int i = 0; i < nbArcs; i++){
+        cost[i] += prefix[windowEnd[i]] - prefix[windowBegin[i]];
+    }
+}
+
+/* Updates the arc costs of graph #d reduced by the A* potential. Labels that cannot reach the target on the physical network get a zero potential:
+   they are only adjacent to one another. */
+void Subgradient::updateReducedCosts(int d){
+    const int target = getToBeRouted_k(d).getTarget();
+    const double multiplier = getLengthMultiplier_d(d);
+    std::vector<double> potential(instance.getNbNodes(), 0.0);
+    for (int label = 0; label < instance.getNbNodes(); label++){
+        if (instance.getMinNbHops(label, target) != INT_MAX){
+            potential[label] = multiplier*instance.getShortestDistance(label, target) + minBaseCost[d]*instance.getMinNbHops(label, target);
+        }
+    }
+    const int nbArcs = vecFlatCost[d].size();
+    for (int i = 0; i < nbArcs; i++){
+        vecFlatReducedCost[d][i] = std::max(0.0, vecFlatCost[d][i] - potential[vecFlatTail[d][i]] + potential[vecFlatHead[d][i]]);
+    }
+}
+
+/* Solves the Lagrangian relaxation of the RSA using the Subgradient Method. */
+void Subgradient::run(){
     bool STOP = false;
-    
-    // run a first shortest path not taking into account length (i.e., u=0)
-    Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > shortestPath((*vecGraph[0]), cost);
-    shortestPath.run(s,t);
-    //displayPath(shortestPath, s, t);
-    
-    if (shortestPath.reached(t) == false){
-        std::cout << "> CSP is not feasible. " << std::endl;
-        exit(0);
-    }
-    
-    setCurrentCost(shortestPath.dist(t) - (MAX_LENGTH*getMultiplier_k(getIteration())));
-    updateLB(getCurrentCost());
-    std::cout << "> Set LB: " << getLB() << std:: endl;
-    updateSlack(getPathLength(shortestPath, s, t));
-
-    // if the path found is unfeasible, check for problem's feasibility
-    if( getPathLength(shortestPath, s, t) >= MAX_LENGTH + EPSILON ){
-        if (testFeasibility(s,t) == false){
-            STOP = true;
+
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        if (vecSource[d] == INVALID || vecTarget[d] == INVALID || testFeasibility(d) == false){
+            std::cout << "> CSP is not feasible for demand " << getToBeRouted_k(d).getId()+1 << ". " << std::endl;
             setIsFeasible(false);
-            std::cout << "> CSP is not feasible. " << std::endl;
-            exit(0);
+            return;
         }
     }
-    else{
-        double ub = getPathCost(shortestPath, s, t);
-        updateUB(ub);
-        std::cout << "> Set UB: " << getUB() << std:: endl;
-        setIsFeasible(true);
-        updateOnPath(shortestPath, s, t);
-    }
 
-    if (getLB() >= getUB() - EPSILON){
-        setIsOptimal(true);
+    /* The length multipliers start at their exact optimum. With a single demand, the non-overlapping multipliers stay null: the dual is solved. */
+    std::vector< std::vector<ListDigraph::Arc> > paths(getNbDemandsToBeRouted());
+    double dualValue = 0.0;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        dualValue += solveLengthDual(d, paths[d]);
+    }
+    updateLB(dualValue);
+    if (getNbDemandsToBeRouted() == 1){
+        updateUB(getPathCost(0, paths[0]));
+        updateOnPath(paths);
+        setIsOptimal(getLB() >= getUB() - EPSILON);
+        updateStatistics();
         STOP = true;
     }
-    
-    
-    updateStepSize();
-    displayMainParameters(shortestPath, s, t);
-    while (!STOP){
-        updateMultiplier();
-        incIteration();
-
-        updateCosts();
-        shortestPath.lengthMap(cost);
-        shortestPath.run(s,t);
+    else{
+        warmStart();
+    }
 
-        setCurrentCost(shortestPath.dist(t) - (MAX_LENGTH*getMultiplier_k(getIteration())));
-        updateSlack(getPathLength(shortestPath, s, t));
+    while (!STOP){
+        if (solveSubproblems() == false){
+            std::cout << "> CSP is not feasible. " << std::endl;
+            setIsFeasible(false);
+            return;
+        }
+        setCurrentCost(getLagrangianValue());
         updateLB(getCurrentCost());
-        double new_path_cost = getPathCost(shortestPath, s, t);
-        if((getSlack_k(getIteration()) >= 0.0 - EPSILON) && (new_path_cost < getUB())){
-            updateUB(new_path_cost);
-            updateOnPath(shortestPath, s, t);
+        updateSlack();
+        repair();
+        synchronizeBounds();
+        updateStatistics();
+        if (getIteration() > 0){
+            updateLambda();
         }
-        updateLambda();
         updateStepSize();
 
-        displayMainParameters(shortestPath, s, t);
+        if (isVerbose()){
+            displayMainParameters();
+        }
         updateStop(STOP);
 
         if (getIteration() >= MAX_NB_IT){
             STOP = true;
         }
-        if(getLB() >= getUB() - EPSILON){
-            setIsOptimal(true);
-            STOP = true;
+        if (!STOP){
+            updateMultiplier();
+            incIteration();
+        }
+    }
+    setIsFeasible(getUB() < __DBL_MAX__);
+    if (getIsFeasible()){
+        storeMultipliers();
+    }
+    if (!isVerbose()){
+        return;
+    }
+    displayStatistics();
+    if (getIsFeasible()){
+        std::cout << "> Best solution found (UB = " << getUB() << ", LB = " << getLB() << "):" << std::endl;
+        displayPaths();
+    }
+}
+
+/* Solves the Lagrangian dual of the length constraint of the d-th demand exactly by a hull search over the (cost, length) extreme points of the paths. */
+double Subgradient::solveLengthDual(int d, std::vector<ListDigraph::Arc> &best){
+    const double maxLength = getToBeRouted_k(d).getMaxLength();
+    std::vector<ListDigraph::Arc> left, right, path;
+
+    /* The cheapest path: if it respects the length limit, u = 0 is optimal. */
+    searchParametricPath(d, 1.0, 0.0, left);
+    double leftCost = getPathCost(d, left);
+    double leftLength = getPathLength(d, left);
+    if (leftLength <= maxLength + EPSILON){
+        lengthMultiplier[d] = 0.0;
+        best = left;
+        if (isVerbose()){
+            std::cout << "> Length dual of demand " << getToBeRouted_k(d).getId()+1 << ": u = 0, L(u) = " << leftCost << " (1 shortest path)." << std::endl;
         }
-        //displayPath(shortestPath, s, t);
+        return leftCost;
     }
+
+    /* The shortest path respects the length limit, since feasibility has been tested. */
+    searchParametricPath(d, 0.0, 1.0, right);
+    double rightCost = getPathCost(d, right);
+    double rightLength = getPathLength(d, right);
+    best = right;
+    int nbPaths = 2;
+
+    /* Invariant: left exceeds the length limit and right respects it. The search stops when no path lies below the segment joining them. */
+    double u = 0.0;
+    while (true){
+        u = (rightCost - leftCost)/(leftLength - rightLength);
+        searchParametricPath(d, 1.0, u, path);
+        nbPaths++;
+        double cost = getPathCost(d, path);
+        double length = getPathLength(d, path);
+        if (cost + u*length >= leftCost + u*leftLength - EPSILON){
+            break;
+        }
+        if (length > maxLength + EPSILON){
+            left.swap(path);
+            leftCost = cost;
+            leftLength = length;
+        }
+        else{
+            right.swap(path);
+            rightCost = cost;
+            rightLength = length;
+            if (rightCost < getPathCost(d, best)){
+                best = right;
+            }
+        }
+    }
+    lengthMultiplier[d] = u;
+    double value = leftCost + u*(leftLength - maxLength);
+    if (isVerbose()){
+        std::cout << "> Length dual of demand " << getToBeRouted_k(d).getId()+1 << ": u = " << u << ", L(u) = " << value << " (" << nbPaths << " shortest paths)." << std::endl;
+    }
+    return value;
 }
 
+/* Seeds the overlap multipliers and lambda with the values cached for similar demands. The exact length multipliers are kept. */
+void Subgradient::warmStart(){
+    if (cache == NULL){
+        return;
+    }
+    int nbFound = 0;
+    double cachedLambda = 0.0;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        MultiplierCache::Entry entry;
+        if (cache->find(getToBeRouted_k(d), entry)){
+            cachedLambda = std::max(cachedLambda, entry.lambda);
+            /* Every non-negative overlap multiplier is valid: the conflicts priced by each cached run are kept. */
+            if (entry.overlapMultiplier.size() == overlapMultiplier.size()){
+                for (unsigned int i = 0; i < overlapMultiplier.size(); i++){
+                    overlapMultiplier[i] = std::max(overlapMultiplier[i], entry.overlapMultiplier[i]);
+                }
+            }
+            nbFound++;
+        }
+    }
+    if (nbFound > 0){
+        setLambda(cachedLambda);
+        std::cout << "> Warm start from the multipliers of " << nbFound << " similar demands (lambda = " << getLambda() << ")." << std::endl;
+    }
+}
+
+/* Stores in the cache the overlap multipliers giving the best LB and the last lambda. A single demand never iterates and never reads the cache: nothing is stored. */
+void Subgradient::storeMultipliers(){
+    if (cache == NULL || getNbDemandsToBeRouted() == 1){
+        return;
+    }
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        MultiplierCache::Entry entry;
+        entry.overlapMultiplier = bestOverlapMultiplier;
+        entry.lambda = getLambda();
+        cache->store(getToBeRouted_k(d), entry);
+    }
+}
+
+/* Stores in path the shortest path of graph #d with arc weights costWeight*c + lengthWeight*length. */
+void Subgradient::searchParametricPath(int d, double costWeight, double lengthWeight, std::vector<ListDigraph::Arc> &path){
+    std::vector<double> weight(vecFlatCost[d].size());
+    for (unsigned int i = 0; i < weight.size(); i++){
+        weight[i] = costWeight*vecFlatBaseCost[d][i] + lengthWeight*vecFlatLength[d][i];
+    }
+    FlatArcCost weightMap(weight);
+    Dijkstra< ListDigraph, FlatArcCost > shortestPath((*vecGraph[d]), weightMap);
+    shortestPath.run(vecSource[d], vecTarget[d]);
+    nbShortestPaths++;
+    storePath(shortestPath, d, path);
+}
+
+/* Solves the shortest path subproblem of every demand, using several threads. Returns false if some demand cannot reach its target. */
+bool Subgradient::solveSubproblems(){
+    int nbWorkers = NB_THREADS;
+    if (nbWorkers <= 0){
+        nbWorkers = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    nbWorkers = std::min(nbWorkers, getNbDemandsToBeRouted());
+    nbShortestPaths += getNbDemandsToBeRouted();
+    updateOverlapPrefix();
+    if (nbWorkers <= 1){
+        solveSubproblems(0, getNbDemandsToBeRouted(), 1);
+    }
+    else{
+        /* Each demand has its own graph and cost map: threads never share data. */
+        std::vector<std::thread> workers;
+        for (int t = 0; t < nbWorkers; t++){
+            workers.emplace_back(static_cast<void (Subgradient::*)(int, int, int)>(&Subgradient::solveSubproblems), this, t, getNbDemandsToBeRouted(), nbWorkers);
+        }
+        for (unsigned int t = 0; t < workers.size(); t++){
+            workers[t].join();
+        }
+    }
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        if (vecPath[d].empty()){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Solves the shortest path subproblem of every demand with index in [first, ..., last) by steps of step. */
+void Subgradient::solveSubproblems(int first, int last, int step){
+    for (int d = first; d < last; d += step){
+        updateCosts(d);
+        updateReducedCosts(d);
+        vecPath[d].clear();
+        if (vecDeltaStepping[d]){
+            vecDeltaStepping[d]->run(vecFlatReducedCost[d], vecSource[d], vecTarget[d]);
+            if (vecDeltaStepping[d]->reached(vecTarget[d])){
+                storePath(*vecDeltaStepping[d], d, vecPath[d]);
+            }
+        }
+        else{
+            FlatArcCost reducedCostMap(vecFlatReducedCost[d]);
+            Dijkstra< ListDigraph, FlatArcCost > shortestPath((*vecGraph[d]), reducedCostMap);
+            shortestPath.run(vecSource[d], vecTarget[d]);
+            if (shortestPath.reached(vecTarget[d])){
+                storePath(shortestPath, d, vecPath[d]);
+            }
+        }
+        if (!vecPath[d].empty()){
+            pathDist[d] = 0.0;
+            for (unsigned int i = 0; i < vecPath[d].size(); i++){
+                pathDist[d] += vecFlatCost[d][ListDigraph::id(vecPath[d][i])];
+            }
+        }
+    }
+}
+
+/* Returns the value of the Lagrangian function for the paths found in the current iteration. */
+double Subgradient::getLagrangianValue(){
+    double value = 0.0;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        value += pathDist[d] - (getToBeRouted_k(d).getMaxLength()*getLengthMultiplier_d(d));
+    }
+    for (unsigned int i = 0; i < overlapMultiplier.size(); i++){
+        value -= overlapMultiplier[i];
+    }
+    return value;
+}
 
 /* Updates the known lower bound. */
 void Subgradient::updateLB(double bound){
     if (bound > getLB()){
         setLB(bound);
+        bestLengthMultiplier = lengthMultiplier;
+        bestOverlapMultiplier = overlapMultiplier;
         setItWithoutImprovement(0);
     }
     else{
         incItWithoutImprovement();
     }
+    if (shared != NULL){
+        double sharedLB = shared->LB.load();
+        while (bound > sharedLB && !shared->LB.compare_exchange_weak(sharedLB, bound)){}
+    }
 }
 
-/* Updates the known upper bound. */
+/* Updates the known upper bound. In a multi-start run, this trajectory becomes the owner of the incumbent if it improves the shared UB. */
 void Subgradient::updateUB(double bound){
     if (bound < getUB()){
         setUB(bound);
     }
+    if (shared != NULL){
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        if (bound < shared->UB.load()){
+            shared->UB.store(bound);
+            shared->owner.store(startId);
+        }
+    }
+}
+
+/* Takes the best upper bound found by the other trajectories of a multi-start run. */
+void Subgradient::synchronizeBounds(){
+    if (shared != NULL && shared->UB.load() < getUB()){
+        setUB(shared->UB.load());
+    }
+}
+
+/* Returns the length multipliers followed by the overlap multipliers. */
+std::vector<double> Subgradient::getMultipliers() const {
+    std::vector<double> multipliers(lengthMultiplier);
+    multipliers.insert(multipliers.end(), overlapMultiplier.begin(), overlapMultiplier.end());
+    return multipliers;
+}
+
+/* Sets the length multipliers followed by the overlap multipliers, projecting them on the non-negative orthant. */
+void Subgradient::setMultipliers(const std::vector<double> &multipliers){
+    for (unsigned int d = 0; d < lengthMultiplier.size(); d++){
+        lengthMultiplier[d] = std::max(multipliers[d], 0.0);
+    }
+    for (unsigned int i = 0; i < overlapMultiplier.size(); i++){
+        overlapMultiplier[i] = std::max(multipliers[lengthMultiplier.size() + i], 0.0);
+    }
 }
 
-/* Updates lagrangian multiplier with the rule: u[k+1] = u[k] + t[k]*violation */
+/* Returns the subgradient (i.e., the violation of each relaxed constraint) for the paths found in the current iteration. */
+std::vector<double> Subgradient::getSubgradient() const {
+    std::vector<double> subgradient(lengthSlack.size() + overlapSlack.size());
+    for (unsigned int d = 0; d < lengthSlack.size(); d++){
+        subgradient[d] = -lengthSlack[d];
+    }
+    for (unsigned int i = 0; i < overlapSlack.size(); i++){
+        subgradient[lengthSlack.size() + i] = -overlapSlack[i];
+    }
+    return subgradient;
+}
+
+/* Updates lagrangian multipliers according to the rule chosen in Input. */
 void Subgradient::updateMultiplier(){
-    double violation = -getLastSlack();
-    double new_multipliplier = getLastMultiplier() + (getLastStepSize()*violation);
-    lagrangianMultiplier.push_back(std::max(new_multipliplier,0.0));
+    switch (MULTIPLIER_UPDATE){
+        case Input::MULTIPLIER_UPDATE_DEFLECTED:
+            updateDeflectedMultiplier();
+            break;
+        case Input::MULTIPLIER_UPDATE_VOLUME:
+            updateVolumeMultiplier();
+            break;
+        case Input::MULTIPLIER_UPDATE_BUNDLE:
+            updateBundleMultiplier();
+            break;
+        default:
+            updateSubgradientMultiplier();
+            break;
+    }
+}
+
+/* Updates lagrangian multipliers with the rule: u[k+1] = max(0, u[k] + t[k]*violation) */
+void Subgradient::updateSubgradientMultiplier(){
+    for (unsigned int d = 0; d < lengthMultiplier.size(); d++){
+        double violation = -lengthSlack[d];
+        lengthMultiplier[d] = std::max(lengthMultiplier[d] + (getStepSize()*violation), 0.0);
+    }
+    for (unsigned int i = 0; i < overlapMultiplier.size(); i++){
+        double violation = -overlapSlack[i];
+        overlapMultiplier[i] = std::max(overlapMultiplier[i] + (getStepSize()*violation), 0.0);
+    }
 
     //displayMultiplier();
 }
 
-/* Updates the step size with the rule: lambda*(UB - Z[u])/|slack| */
-void Subgradient::updateStepSize(){
-    int k = getIteration();
-    double numerator = getLambda_k(k)*(getUB() - getCurrentCost());
-    double denominator = std::pow(std::sqrt(getSlack_k(k)*getSlack_k(k)), 2);
-    double new_stepSize = (numerator/denominator); 
-    stepSize.push_back(new_stepSize);
+/* Updates lagrangian multipliers along the direction d[k] = g[k] + beta*d[k-1], where beta = max(0, -1.5*g[k].d[k-1]/|d[k-1]|^2). */
+void Subgradient::updateDeflectedMultiplier(){
+    const double DEFLECTION = 1.5;
+    std::vector<double> multipliers = getMultipliers();
+    std::vector<double> subgradient = getSubgradient();
+    for (unsigned int i = 0; i < subgradient.size(); i++){
+        if (multipliers[i] <= 0.0 && subgradient[i] < 0.0){
+            subgradient[i] = 0.0;
+        }
+    }
+    /* The previous direction is only kept when it makes an obtuse angle with the subgradient. */
+    if (direction.size() == subgradient.size()){
+        double product = std::inner_product(subgradient.begin(), subgradient.end(), direction.begin(), 0.0);
+        double norm = std::inner_product(direction.begin(), direction.end(), direction.begin(), 0.0);
+        if (product < 0.0 && norm > EPSILON){
+            double beta = -DEFLECTION*product/norm;
+            for (unsigned int i = 0; i < subgradient.size(); i++){
+                subgradient[i] += beta*direction[i];
+            }
+        }
+    }
+    direction.swap(subgradient);
+    double norm = std::inner_product(direction.begin(), direction.end(), direction.begin(), 0.0);
+    if (norm < EPSILON){
+        return;
+    }
+    double step = getPolyakStep(getCurrentCost(), norm);
+    for (unsigned int i = 0; i < multipliers.size(); i++){
+        multipliers[i] += step*direction[i];
+    }
+    setMultipliers(multipliers);
+}
+
+/* Updates lagrangian multipliers with the volume algorithm. */
+void Subgradient::updateVolumeMultiplier(){
+    const double AVERAGE_WEIGHT = 0.1;
+    std::vector<double> subgradient = getSubgradient();
+    bool isFirst = center.empty();
+    double alpha = isFirst ? 1.0 : AVERAGE_WEIGHT;
+    if (isFirst || getCurrentCost() > centerValue){
+        center = getMultipliers();
+        centerValue = getCurrentCost();
+    }
+    if (isFirst){
+        aggregate = subgradient;
+    }
+    else{
+        for (unsigned int i = 0; i < aggregate.size(); i++){
+            aggregate[i] = alpha*subgradient[i] + (1.0 - alpha)*aggregate[i];
+        }
+    }
+    updatePrimalEstimate(alpha);
+
+    double norm = 0.0;
+    for (unsigned int i = 0; i < aggregate.size(); i++){
+        if (center[i] > 0.0 || aggregate[i] > 0.0){
+            norm += aggregate[i]*aggregate[i];
+        }
+    }
+    if (norm < EPSILON){
+        return;
+    }
+    double step = getPolyakStep(centerValue, norm);
+    std::vector<double> multipliers(center);
+    for (unsigned int i = 0; i < multipliers.size(); i++){
+        multipliers[i] += step*aggregate[i];
+    }
+    setMultipliers(multipliers);
+}
+
+/* Updates lagrangian multipliers with a proximal bundle method keeping a few cuts, which are aggregated when the bundle is full. */
+void Subgradient::updateBundleMultiplier(){
+    const double SERIOUS_STEP = 0.1;
+    const unsigned int MAX_BUNDLE_SIZE = 10;
+    std::vector<double> multipliers = getMultipliers();
+    std::vector<double> subgradient = getSubgradient();
+    /* On the non-negative orthant, the cut stays valid without the components that can only decrease a null multiplier. */
+    for (unsigned int i = 0; i < subgradient.size(); i++){
+        if (multipliers[i] <= 0.0 && subgradient[i] < 0.0){
+            subgradient[i] = 0.0;
+        }
+    }
+    double error = 0.0;
+    if (center.empty()){
+        center = multipliers;
+        centerValue = getCurrentCost();
+        double norm = std::inner_product(subgradient.begin(), subgradient.end(), subgradient.begin(), 0.0);
+        proximalParameter = (norm > EPSILON) ? getPolyakStep(getCurrentCost(), norm) : 1.0;
+    }
+    else{
+        /* The error of a cut is the gap between its value at the center and the lagrangian value of the center. */
+        double increase = getCurrentCost() - centerValue;
+        if (increase >= SERIOUS_STEP*predictedIncrease){
+            for (unsigned int k = 0; k < bundle.size(); k++){
+                for (unsigned int i = 0; i < center.size(); i++){
+                    bundleError[k] += bundle[k][i]*(multipliers[i] - center[i]);
+                }
+                bundleError[k] = std::max(bundleError[k] - increase, 0.0);
+            }
+            if (increase >= 0.5*predictedIncrease){
+                proximalParameter *= 2.0;
+            }
+            center = multipliers;
+            centerValue = getCurrentCost();
+        }
+        else{
+            error = getCurrentCost() - centerValue;
+            for (unsigned int i = 0; i < center.size(); i++){
+                error += subgradient[i]*(center[i] - multipliers[i]);
+            }
+            error = std::max(error, 0.0);
+        }
+    }
+    /* A full bundle is compressed into its aggregated cut. */
+    if (bundle.size() >= MAX_BUNDLE_SIZE){
+        bundle.assign(1, aggregate);
+        bundleError.assign(1, aggregateError);
+    }
+    bundle.push_back(subgradient);
+    bundleError.push_back(error);
+
+    /* The aggregated cut is the convex combination of cuts solving the dual of the proximal problem. */
+    std::vector<double> weight = solveProximalProblem();
+    aggregate.assign(subgradient.size(), 0.0);
+    aggregateError = 0.0;
+    for (unsigned int k = 0; k < bundle.size(); k++){
+        for (unsigned int i = 0; i < aggregate.size(); i++){
+            aggregate[i] += weight[k]*bundle[k][i];
+        }
+        aggregateError += weight[k]*bundleError[k];
+    }
 
-    //displayStepSize();
+    /* The candidate maximizes the model around the center; the predicted increase is the model value there. */
+    for (unsigned int i = 0; i < multipliers.size(); i++){
+        multipliers[i] = center[i] + proximalParameter*aggregate[i];
+    }
+    setMultipliers(multipliers);
+    multipliers = getMultipliers();
+    predictedIncrease = aggregateError;
+    for (unsigned int i = 0; i < multipliers.size(); i++){
+        predictedIncrease += aggregate[i]*(multipliers[i] - center[i]);
+    }
+}
+
+/* Returns the weights of the cuts minimizing t/2*|sum of w[k]*g[k]|^2 + sum of w[k]*e[k] over the simplex, by projected gradient. */
+std::vector<double> Subgradient::solveProximalProblem(){
+    const int NB_STEPS = 500;
+    const int size = bundle.size();
+    std::vector< std::vector<double> > gram(size, std::vector<double>(size, 0.0));
+    double trace = 0.0;
+    for (int k = 0; k < size; k++){
+        for (int l = k; l < size; l++){
+            gram[k][l] = proximalParameter*std::inner_product(bundle[k].begin(), bundle[k].end(), bundle[l].begin(), 0.0);
+            gram[l][k] = gram[k][l];
+        }
+        trace += gram[k][k];
+    }
+    /* The newest cut is the starting point. */
+    std::vector<double> weight(size, 0.0);
+    weight[size - 1] = 1.0;
+    if (trace < EPSILON){
+        std::vector<double>::iterator cheapest = std::min_element(bundleError.begin(), bundleError.end());
+        weight.assign(size, 0.0);
+        weight[cheapest - bundleError.begin()] = 1.0;
+        return weight;
+    }
+    std::vector<double> point(size), sorted(size);
+    for (int step = 0; step < NB_STEPS; step++){
+        for (int k = 0; k < size; k++){
+            point[k] = weight[k] - (std::inner_product(gram[k].begin(), gram[k].end(), weight.begin(), 0.0) + bundleError[k])/trace;
+        }
+        /* Euclidean projection on the simplex. */
+        sorted = point;
+        std::sort(sorted.begin(), sorted.end(), std::greater<double>());
+        double sum = 0.0, shift = 0.0;
+        for (int k = 0; k < size; k++){
+            sum += sorted[k];
+            if (sorted[k] - (sum - 1.0)/(k + 1) > 0.0){
+                shift = (sum - 1.0)/(k + 1);
+            }
+        }
+        for (int k = 0; k < size; k++){
+            weight[k] = std::max(point[k] - shift, 0.0);
+        }
+    }
+    return weight;
+}
+
+/* Updates the primal estimates: x = alpha*x[k] + (1 - alpha)*x. */
+void Subgradient::updatePrimalEstimate(double alpha){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            (*vecPrimal[d])[a] *= (1.0 - alpha);
+        }
+        for (unsigned int i = 0; i < vecPath[d].size(); i++){
+            (*vecPrimal[d])[vecPath[d][i]] += alpha;
+        }
+    }
+}
+
+/* Returns the step lambda*(UB - value)/norm, estimating UB from value while no feasible solution is known. */
+double Subgradient::getPolyakStep(double value, double norm){
+    double target = getUB();
+    if (target >= __DBL_MAX__){
+        target = value + std::max(1.0, std::abs(value));
+    }
+    return getLambda()*(target - value)/norm;
+}
+
+/* Updates the step size with the rule: lambda*(UB - Z[u])/|g|^2 */
+void Subgradient::updateStepSize(){
+    double denominator = getSubgradientNorm();
+    if (denominator < EPSILON){
+        setStepSize(0.0);
+        return;
+    }
+    setStepSize(getPolyakStep(getCurrentCost(), denominator));
 }
 
 /* Updates the lambda used in the update of step size. Lambda is halved if LB has failed to increade in some fixed number of iterations */
 void Subgradient::updateLambda(){
-    double new_lambda = getLastLambda();
     if (getItWithoutImprovement() >= MAX_NB_IT_WITHOUT_IMPROVEMENT){
         setItWithoutImprovement(0);
-        new_lambda = new_lambda / 2;
+        setLambda(getLambda() / 2);
     }
-    lambda.push_back(new_lambda);
-
-    //displayLambda();
 }
 
-
-/* Updates the slack of length constraint for a given path length */
-void Subgradient::updateSlack(double pathLength){
-    slack.push_back(MAX_LENGTH - pathLength);
+/* Updates the slack of the relaxed constraints for the paths found in the current iteration */
+void Subgradient::updateSlack(){
+    overlapSlack.assign(overlapSlack.size(), 1.0);
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        const int load = getToBeRouted_k(d).getLoad();
+        lengthSlack[d] = getToBeRouted_k(d).getMaxLength() - getPathLength(d, vecPath[d]);
+        for (unsigned int i = 0; i < vecPath[d].size(); i++){
+            int label = getArcLabel(vecPath[d][i], d);
+            int slice = getArcSlice(vecPath[d][i], d);
+            for (int s = std::max(0, slice - load + 1); s <= slice; s++){
+                overlapSlack[label*nbSlices + s] -= 1.0;
+            }
+        }
+    }
 
     //displaySlack();
 }
 
-/* Assigns length as the main cost of the arcs. */
-void Subgradient::setLengthCost(){
-    for (ListDigraph::ArcIt a(*vecGraph[0]); a != INVALID; ++a){
-        cost[a] = getArcLength(a, 0) ;
+/* Returns the squared norm of the subgradient, ignoring the components that cannot move a null multiplier. */
+double Subgradient::getSubgradientNorm(){
+    double norm = 0.0;
+    for (unsigned int d = 0; d < lengthMultiplier.size(); d++){
+        if (lengthMultiplier[d] > 0.0 || lengthSlack[d] < 0.0){
+            norm += lengthSlack[d]*lengthSlack[d];
+        }
+    }
+    for (unsigned int i = 0; i < overlapMultiplier.size(); i++){
+        if (overlapMultiplier[i] > 0.0 || overlapSlack[i] < 0.0){
+            norm += overlapSlack[i]*overlapSlack[i];
+        }
+    }
+    return norm;
+}
+
+/* Returns the relative gap between the bounds, or __DBL_MAX__ while no feasible solution is known. */
+double Subgradient::getGap(){
+    if (getUB() >= __DBL_MAX__){
+        return __DBL_MAX__;
+    }
+    return (getUB() - getLB())/std::max(std::abs(getUB()), EPSILON);
+}
+
+/* Records the iteration, time and number of shortest paths at which the gap first reaches TARGET_GAP. */
+void Subgradient::updateStatistics(){
+    if (itToGap == -1 && getGap() <= TARGET_GAP){
+        itToGap = getIteration();
+        timeToGap = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+        nbShortestPathsToGap = nbShortestPaths;
     }
 }
 
@@ -203,164 +823,434 @@ void Subgradient::updateStop(bool &STOP){
         setIsOptimal(true);
         STOP = true;
     }
+    if (getStepSize() <= 0.0){
+        STOP = true;
+    }
+    /* The bundle model predicts no further increase: the center is optimal. */
+    if (predictedIncrease < EPSILON){
+        STOP = true;
+    }
+    /* In a multi-start run, every trajectory stops once the shared bounds meet. */
+    if (shared != NULL && shared->LB.load() >= shared->UB.load() - EPSILON){
+        setIsOptimal(true);
+        STOP = true;
+    }
 }
 
-/* Tests if CSP is feasible by searching for a shortest path with arc costs based on their physical length. */
-bool Subgradient::testFeasibility(const ListDigraph::Node &s, const ListDigraph::Node &t){
-    setLengthCost();
-    Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > shortestLengthPath((*vecGraph[0]), cost);
-    shortestLengthPath.run(s,t);
-    //displayPath(shortestLengthPath, s, t);
-    double smallestLength = getPathLength(shortestLengthPath, s, t);
-    if( smallestLength >= MAX_LENGTH + EPSILON ){
+/* Returns the keys of the arcs of each graph whose Lagrangian bound, with the path of the demand forced through them, exceeds UB. */
+std::vector< std::set<ArcKey> > Subgradient::getFixedArcs(){
+    std::vector< std::set<ArcKey> > fixedArcs(getNbDemandsToBeRouted());
+    lengthMultiplier = bestLengthMultiplier;
+    overlapMultiplier = bestOverlapMultiplier;
+    if (solveSubproblems() == false){
+        return fixedArcs;
+    }
+    const double value = getLagrangianValue();
+    int nbFixed = 0;
+    int nbArcs = 0;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        FlatArcCost costMap(vecFlatCost[d]);
+        Dijkstra< ListDigraph, FlatArcCost > fromSource((*vecGraph[d]), costMap);
+        fromSource.run(vecSource[d]);
+        std::vector<double> toTarget;
+        std::vector<int> nextArc;
+        computeDistancesToTarget(d, vecFlatCost[d], false, toTarget, nextArc);
+        nbShortestPaths += 2;
+
+        /* Forcing arc a replaces the shortest path of graph #d by the shortest path through a. */
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            if (isVirtualArc(a, d)){
+                continue;
+            }
+            nbArcs++;
+            ListDigraph::Node tail = (*vecGraph[d]).source(a);
+            ListDigraph::Node head = (*vecGraph[d]).target(a);
+            bool isFixed = true;
+            if (fromSource.reached(tail) && toTarget[ListDigraph::id(head)] < __DBL_MAX__){
+                double bound = value - pathDist[d] + fromSource.dist(tail) + vecFlatCost[d][ListDigraph::id(a)] + toTarget[ListDigraph::id(head)];
+                isFixed = (bound > getUB() + EPSILON);
+            }
+            if (isFixed){
+                fixedArcs[d].insert(getArcKey(a, d));
+                nbFixed++;
+            }
+        }
+    }
+    std::cout << "> " << nbFixed << " arcs out of " << nbArcs << " are fixed to zero by reduced costs (UB = " << getUB() << ", L(u) = " << value << ")." << std::endl;
+    return fixedArcs;
+}
+
+/* Tests if the d-th demand can be routed by searching for a shortest path with arc costs based on their physical length. */
+bool Subgradient::testFeasibility(int d){
+    /* A path stays on one slice layer: the shortest one is the closest layer of the memoized tree from the source. */
+    const std::vector<double> &fromSource = getLayerTree(d, getToBeRouted_k(d).getSource(), true);
+    int nbLanes = getNbSliceLanes();
+    int target = getToBeRouted_k(d).getTarget();
+    double shortestLength = *std::min_element(fromSource.begin() + target*nbLanes, fromSource.begin() + (target+1)*nbLanes);
+    if (shortestLength >= getToBeRouted_k(d).getMaxLength() + EPSILON){
         std::cout << "> CSP is unfeasiable." << std:: endl;
         return false;
     }
-    else{
-        updateUB(getPathCost(shortestLengthPath, s, t));
-        std::cout << "> Set UB: " << getUB() << std:: endl;
+    return true;
+}
+
+/* Builds a feasible joint assignment from the Lagrangian paths and updates the upper bound and onPath if it is improved. */
+bool Subgradient::repair(){
+    isReserved.assign(instance.getNbEdges(), std::vector<bool>(nbSlices, false));
+    std::vector< std::vector<ListDigraph::Arc> > paths(getNbDemandsToBeRouted());
+    std::vector<bool> isRouted(getNbDemandsToBeRouted(), false);
+    std::vector<int> order(getNbDemandsToBeRouted());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int d1, int d2){ return getToBeRouted_k(d1).getLoad() > getToBeRouted_k(d2).getLoad(); });
+
+    /* Lagrangian paths that are already feasible are kept; the other demands are rerouted around them. */
+    for (unsigned int k = 0; k < order.size(); k++){
+        int d = order[k];
+        if (lengthSlack[d] >= 0.0 - EPSILON && isPathFree(d, vecPath[d])){
+            paths[d] = vecPath[d];
+            reservePath(d, paths[d]);
+            isRouted[d] = true;
+        }
+    }
+    for (unsigned int k = 0; k < order.size(); k++){
+        int d = order[k];
+        if (isRouted[d] == false){
+            if (repairPath(d, paths[d]) == false){
+                return false;
+            }
+            reservePath(d, paths[d]);
+        }
+    }
+
+    double cost = 0.0;
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        cost += getPathCost(d, paths[d]);
+    }
+    if (cost < getUB()){
+        updateUB(cost);
+        updateOnPath(paths);
+    }
+    return true;
+}
+
+/* Searches for a path of graph #d that respects the length limit and only uses free slice windows, first with Lagrangian costs and then with lengths. */
+bool Subgradient::repairPath(int d, std::vector<ListDigraph::Arc> &path){
+    const double BLOCKED_COST = 1e12;
+    std::vector<double> repairCost(vecFlatCost[d].size());
+    FlatArcCost repairMap(repairCost);
+    for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+        if (isWindowFree(d, a) == false){
+            repairCost[ListDigraph::id(a)] = BLOCKED_COST;
+        }
+        else{
+            repairCost[ListDigraph::id(a)] = vecFlatCost[d][ListDigraph::id(a)];
+        }
+    }
+    Dijkstra< ListDigraph, FlatArcCost > shortestPath((*vecGraph[d]), repairMap);
+    shortestPath.run(vecSource[d], vecTarget[d]);
+    nbShortestPaths++;
+    std::vector<ListDigraph::Arc> lagrangianPath;
+    if (shortestPath.reached(vecTarget[d])){
+        storePath(shortestPath, d, lagrangianPath);
+        if (isPathFree(d, lagrangianPath) == false){
+            lagrangianPath.clear();
+        }
+        else if (getPathLength(d, lagrangianPath) <= getToBeRouted_k(d).getMaxLength() + EPSILON){
+            path = lagrangianPath;
+            return true;
+        }
+    }
+    return splicePath(d, lagrangianPath, path);
+}
+
+/* Stores in path the cheapest splice of a prefix of longPath with a shortest-length suffix of graph #d, within the length limit. */
+bool Subgradient::splicePath(int d, const std::vector<ListDigraph::Arc> &longPath, std::vector<ListDigraph::Arc> &path){
+    const double maxLength = getToBeRouted_k(d).getMaxLength();
+    std::vector<double> dist;
+    std::vector<int> nextArc;
+    computeDistancesToTarget(d, vecFlatLength[d], true, dist, nextArc);
+    nbShortestPaths++;
+
+    /* onPrefix[node] is true if the node belongs to the current prefix: a suffix going through it would make a cycle. */
+    std::vector<bool> onPrefix((*vecGraph[d]).maxNodeId() + 1, false);
+    double bestCost = __DBL_MAX__;
+    int bestPrefix = -1;
+    double prefixLength = 0.0;
+    double prefixCost = 0.0;
+    ListDigraph::Node node = vecSource[d];
+    for (unsigned int k = 0; k <= longPath.size(); k++){
+        onPrefix[ListDigraph::id(node)] = true;
+        if (prefixLength + dist[ListDigraph::id(node)] <= maxLength + EPSILON){
+            double cost = prefixCost;
+            bool isSimple = true;
+            for (ListDigraph::Node v = node; v != vecTarget[d]; ){
+                ListDigraph::Arc a = ListDigraph::arcFromId(nextArc[ListDigraph::id(v)]);
+                cost += vecFlatBaseCost[d][ListDigraph::id(a)];
+                v = (*vecGraph[d]).target(a);
+                if (onPrefix[ListDigraph::id(v)]){
+                    isSimple = false;
+                    break;
+                }
+            }
+            if (isSimple && cost < bestCost){
+                bestCost = cost;
+                bestPrefix = k;
+            }
+        }
+        if (k == longPath.size() || node == vecTarget[d]){
+            break;
+        }
+        prefixLength += vecFlatLength[d][ListDigraph::id(longPath[k])];
+        prefixCost += vecFlatBaseCost[d][ListDigraph::id(longPath[k])];
+        /* The path has no virtual arc: its first node is a source copy, not the virtual source. */
+        onPrefix[ListDigraph::id((*vecGraph[d]).source(longPath[k]))] = true;
+        node = (*vecGraph[d]).target(longPath[k]);
+    }
+    path.clear();
+    if (bestPrefix == -1){
+        return false;
+    }
+    path.assign(longPath.begin(), longPath.begin() + bestPrefix);
+    ListDigraph::Node v = (bestPrefix == 0) ? vecSource[d] : (*vecGraph[d]).target(longPath[bestPrefix - 1]);
+    while (v != vecTarget[d]){
+        ListDigraph::Arc a = ListDigraph::arcFromId(nextArc[ListDigraph::id(v)]);
+        if (isVirtualArc(a, d) == false){
+            path.push_back(a);
+        }
+        v = (*vecGraph[d]).target(a);
+    }
+    return true;
+}
+
+/* Computes the distance from each node of graph #d to the target with the given arc weights, following arcs backward. */
+void Subgradient::computeDistancesToTarget(int d, const std::vector<double> &weight, bool onlyFreeWindows, std::vector<double> &dist, std::vector<int> &nextArc){
+    typedef std::pair<double, int> Entry;
+    std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    dist.assign((*vecGraph[d]).maxNodeId() + 1, __DBL_MAX__);
+    nextArc.assign((*vecGraph[d]).maxNodeId() + 1, -1);
+    dist[ListDigraph::id(vecTarget[d])] = 0.0;
+    heap.push(Entry(0.0, ListDigraph::id(vecTarget[d])));
+    while (!heap.empty()){
+        double nodeDist = heap.top().first;
+        int node = heap.top().second;
+        heap.pop();
+        if (nodeDist > dist[node]){
+            continue;
+        }
+        for (ListDigraph::InArcIt a(*vecGraph[d], ListDigraph::nodeFromId(node)); a != INVALID; ++a){
+            if (onlyFreeWindows && isWindowFree(d, a) == false){
+                continue;
+            }
+            int previous = ListDigraph::id((*vecGraph[d]).source(a));
+            if (nodeDist + weight[ListDigraph::id(a)] < dist[previous]){
+                dist[previous] = nodeDist + weight[ListDigraph::id(a)];
+                nextArc[previous] = ListDigraph::id(a);
+                heap.push(Entry(dist[previous], previous));
+            }
+        }
+    }
+}
+
+/* Returns true if the slice window covered by arc a of graph #d is free (i.e., not reserved by a repaired demand). Virtual arcs cover no window. */
+bool Subgradient::isWindowFree(int d, const ListDigraph::Arc &a){
+    if (isVirtualArc(a, d)){
+        return true;
+    }
+    int label = getArcLabel(a, d);
+    int slice = getArcSlice(a, d);
+    for (int s = std::max(0, slice - getToBeRouted_k(d).getLoad() + 1); s <= slice; s++){
+        if (isReserved[label][s]){
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Returns true if every arc of the path of graph #d has a free slice window. */
+bool Subgradient::isPathFree(int d, const std::vector<ListDigraph::Arc> &path){
+    for (unsigned int i = 0; i < path.size(); i++){
+        if (isWindowFree(d, path[i]) == false){
+            return false;
+        }
     }
     return true;
 }
 
-/* Stores the path found in the arcMap onPath. */
-void Subgradient::updateOnPath(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t){
-    ListDigraph::Node n = t;
-    for (ListDigraph::ArcIt a(*vecGraph[0]); a != INVALID; ++a){
-        (*vecOnPath[0])[a] = -1;
+/* Reserves the slice windows covered by the path of graph #d. */
+void Subgradient::reservePath(int d, const std::vector<ListDigraph::Arc> &path){
+    for (unsigned int i = 0; i < path.size(); i++){
+        int label = getArcLabel(path[i], d);
+        int slice = getArcSlice(path[i], d);
+        for (int s = std::max(0, slice - getToBeRouted_k(d).getLoad() + 1); s <= slice; s++){
+            isReserved[label][s] = true;
+        }
     }
-    while (n != s){
-        ListDigraph::Arc arc = path.predArc(n);
-        n = path.predNode(n);
-        (*vecOnPath[0])[arc] = getToBeRouted()[0].getId();
+}
+
+/* Stores the path found by a Dijkstra run on graph #d, from source to target, without its virtual arcs. */
+void Subgradient::storePath(Dijkstra< ListDigraph, FlatArcCost > &shortestPath, int d, std::vector<ListDigraph::Arc> &path){
+    path.clear();
+    ListDigraph::Node n = vecTarget[d];
+    while (n != vecSource[d]){
+        if (isVirtualArc(shortestPath.predArc(n), d) == false){
+            path.push_back(shortestPath.predArc(n));
+        }
+        n = shortestPath.predNode(n);
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+/* Stores the path found by a delta-stepping run on graph #d, from source to target, without its virtual arcs. */
+void Subgradient::storePath(const DeltaStepping &shortestPath, int d, std::vector<ListDigraph::Arc> &path){
+    path.clear();
+    ListDigraph::Node n = vecTarget[d];
+    while (n != vecSource[d]){
+        if (isVirtualArc(shortestPath.predArc(n), d) == false){
+            path.push_back(shortestPath.predArc(n));
+        }
+        n = shortestPath.predNode(n);
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+/* Builds the delta-stepping search of the graphs with at least DELTA_STEPPING_MIN_ARCS arcs, if more threads are available than demands. */
+void Subgradient::buildDeltaStepping(){
+    int nbThreads = NB_THREADS;
+    if (nbThreads <= 0){
+        nbThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    int threadsPerGraph = std::max(1, nbThreads / std::max(1, getNbDemandsToBeRouted()));
+    vecDeltaStepping.clear();
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        vecDeltaStepping.emplace_back();
+        if (threadsPerGraph > 1 && countArcs(*vecGraph[d]) >= DELTA_STEPPING_MIN_ARCS){
+            vecDeltaStepping[d].reset(new DeltaStepping(*vecGraph[d], threadsPerGraph));
+            if (isVerbose()){
+                std::cout << "> Graph #" << d << " is searched by delta-stepping with " << threadsPerGraph << " threads." << std::endl;
+            }
+        }
+    }
+}
+
+/* Stores the paths of every demand in the arcMap onPath. */
+void Subgradient::updateOnPath(const std::vector< std::vector<ListDigraph::Arc> > &paths){
+    for (int d = 0; d < getNbDemandsToBeRouted(); d++){
+        for (ListDigraph::ArcIt a(*vecGraph[d]); a != INVALID; ++a){
+            (*vecOnPath[d])[a] = -1;
+        }
+        for (unsigned int i = 0; i < paths[d].size(); i++){
+            (*vecOnPath[d])[paths[d][i]] = getToBeRouted_k(d).getId();
+        }
     }
 }
 
 
-/* Returns the physical length of the path. */
-double Subgradient::getPathLength(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t){
+/* Returns the physical length of a path of graph #d. */
+double Subgradient::getPathLength(int d, const std::vector<ListDigraph::Arc> &path){
     double pathLength = 0.0;
-    ListDigraph::Node n = t;
-    while (n != s){
-        ListDigraph::Arc arc = path.predArc(n);
-        n = path.predNode(n);
-        pathLength += getArcLength(arc, 0);
+    for (unsigned int i = 0; i < path.size(); i++){
+        pathLength += vecFlatLength[d][ListDigraph::id(path[i])];
     }
     return pathLength;
 }
 
-/* Returns the actual cost of the path according to the metric used. */
-double Subgradient::getPathCost(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t){
+/* Returns the actual cost of a path of graph #d according to the metric used. */
+double Subgradient::getPathCost(int d, const std::vector<ListDigraph::Arc> &path){
     double pathCost = 0.0;
-    ListDigraph::Node n = t;
-    while (n != s){
-        ListDigraph::Arc arc = path.predArc(n);
-        n = path.predNode(n);
-        pathCost += getCoeff(arc, 0);
+    for (unsigned int i = 0; i < path.size(); i++){
+        pathCost += vecFlatBaseCost[d][ListDigraph::id(path[i])];
     }
     return pathCost;
 }
 
-void Subgradient::displayPath(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t){
-    std::cout << "The path found is:" << std::endl;
-    ListDigraph::Node n = t;
-    while (n != s){
-        ListDigraph::Arc arc = path.predArc(n);
-        n = path.predNode(n);
-        displayArc(0, arc);
-    }
-    double pathLength = getPathLength(path, s, t);
-    std::cout << "Path length: " << pathLength << std::endl;
-    double pathCost = getPathCost(path, s, t);
-    std::cout << "Path cost: " << pathCost << std::endl;
-    double lagrangianObjFunc = path.dist(t);
-    std::cout << "Lagrangian Objective Function: " << lagrangianObjFunc << std::endl;
-}
-
-std::string Subgradient::getPathString(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t){
+std::string Subgradient::getPathString(int d, const std::vector<ListDigraph::Arc> &path){
     std::string pathString = "";
-    ListDigraph::Node n = t;
-    while (n != s){
-        pathString += "(" + std::to_string(getNodeLabel(n, 0) + 1) + "," + std::to_string(getNodeSlice(n, 0) + 1) + ")";
+    for (unsigned int i = 0; i < path.size(); i++){
+        ListDigraph::Node n = (*vecGraph[d]).source(path[i]);
+        pathString += "(" + std::to_string(getNodeLabel(n, d) + 1) + "," + std::to_string(getArcSlice(path[i], d) + 1) + ")";
         pathString += "-";
-        n = path.predNode(n);
     }
-    pathString += "(" + std::to_string(getNodeLabel(s, 0) + 1) + "," + std::to_string(getNodeSlice(s, 0) + 1) + ")";
+    if (!path.empty()){
+        ListDigraph::Node n = (*vecGraph[d]).target(path[path.size() - 1]);
+        pathString += "(" + std::to_string(getNodeLabel(n, d) + 1) + "," + std::to_string(getArcSlice(path[path.size() - 1], d) + 1) + ")";
+    }
     return pathString;
 }
- 
 
-void Subgradient::displayMainParameters(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t){
+
+void Subgradient::displayMainParameters(){
     int k = getIteration();
-    int sizeOfField[7];
+    int sizeOfField[6];
     sizeOfField[0] = 4;
     sizeOfField[1] = 5;
     sizeOfField[2] = 5;
     sizeOfField[3] = 11;
-    sizeOfField[4] = 7;
-    sizeOfField[5] = 12;
-    sizeOfField[6] = 13;
+    sizeOfField[4] = 12;
+    sizeOfField[5] = 13;
     char space = ' ';
-    std::string field[8];
+    std::string field[7];
     if (k == 0){
         field[0] = "It k";
         field[1] = "LB[k]";
         field[2] = "UB[k]";
         field[3] = "Lagr(u[k])";
-        field[4] = "u[k]";
-        field[5] = "Slack s[k]";
-        field[6] = "StepSize t[k]";
-        field[7] = "Path P[k]";
-        for (int i = 0; i < 7; i++){
+        field[4] = "|g[k]|^2";
+        field[5] = "StepSize t[k]";
+        field[6] = "Path P[k]";
+        for (int i = 0; i < 6; i++){
             field[i].resize(sizeOfField[i], space);
             std::cout << field[i] << " | ";
         }
-        std::cout << field[7] << std::endl;
+        std::cout << field[6] << std::endl;
     }
     field[0] = std::to_string(k);
     field[1] = std::to_string(getLB());
     field[2] = std::to_string(getUB());
     field[3] = std::to_string(getCurrentCost());
-    field[4] = std::to_string(getMultiplier_k(k));
-    field[5] = std::to_string(getSlack_k(k));
-    field[6] = std::to_string(getStepSize_k(k));
-    field[7] = getPathString(path, s, t);
-    for (int i = 0; i < 7; i++){
+    field[4] = std::to_string(getSubgradientNorm());
+    field[5] = std::to_string(getStepSize());
+    /* Paths are only displayed when a single demand is routed. */
+    field[6] = (getNbDemandsToBeRouted() == 1) ? getPathString(0, vecPath[0]) : "";
+    for (int i = 0; i < 6; i++){
         field[i].resize(sizeOfField[i], space);
         std::cout << field[i] << " | ";
     }
-    std::cout << field[7] << " | " << std::endl;
+    std::cout << field[6] << " | " << std::endl;
 }
 
 void Subgradient::displayMultiplier(){
-    std::string display = "Multiplier = [ ";
-    for (unsigned int i = 0; i < lagrangianMultiplier.size(); i++){
-        display += std::to_string(getMultiplier_k(i)) + " "; 
+    std::string display = "Length multipliers = [ ";
+    for (unsigned int d = 0; d < lengthMultiplier.size(); d++){
+        display += std::to_string(getLengthMultiplier_d(d)) + " ";
     }
     display += "]";
     std::cout << display << std::endl;
-}
-void Subgradient::displayLambda(){
-    std::string display = "Lambda = [ ";
-    for (unsigned int i = 0; i < lambda.size(); i++){
-        display += std::to_string(getLambda_k(i)) + " "; 
+    display = "Non-zero overlap multipliers = [ ";
+    for (unsigned int i = 0; i < overlapMultiplier.size(); i++){
+        if (overlapMultiplier[i] > 0.0){
+            display += "(" + std::to_string(i/nbSlices + 1) + "," + std::to_string(i%nbSlices + 1) + "): " + std::to_string(overlapMultiplier[i]) + " ";
+        }
     }
     display += "]";
     std::cout << display << std::endl;
 }
+
 void Subgradient::displaySlack(){
-    std::string display = "Slack = [ ";
-    for (unsigned int i = 0; i < slack.size(); i++){
-        display += std::to_string(getSlack_k(i)) + " "; 
+    std::string display = "Length slacks = [ ";
+    for (unsigned int d = 0; d < lengthSlack.size(); d++){
+        display += std::to_string(lengthSlack[d]) + " ";
     }
     display += "]";
     std::cout << display << std::endl;
 }
-void Subgradient::displayStepSize(){
-    std::string display = "StepSize = [ ";
-    for (unsigned int i = 0; i < stepSize.size(); i++){
-        display += std::to_string(getStepSize_k(i)) + " "; 
+
+void Subgradient::displayStatistics(){
+    double time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+    std::cout << "> Iterations: " << getIteration() + 1 << ", shortest paths: " << getNbShortestPaths() << ", time: " << time << " sec." << std::endl;
+    if (getItToGap() != -1){
+        std::cout << "> Gap of " << TARGET_GAP << " reached at iteration " << getItToGap() << " after " << getTimeToGap() << " sec (" << nbShortestPathsToGap << " shortest paths)." << std::endl;
     }
-    display += "]";
-    std::cout << display << std::endl;
-}
\ No newline at end of file
+    else{
+        std::cout << "> Gap of " << TARGET_GAP << " not reached." << std::endl;
+    }
+}
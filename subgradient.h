@@ -2,19 +2,43 @@
 #define __subgradient__h
 
 #include "RSA.h"
+#include "multiplierCache.h"
+#include "deltaStepping.h"
+
+#include <chrono>
+#include <atomic>
+#include <mutex>
 
 using namespace lemon;
-// For the moment only k=1 is implemented
+
+/* Bounds shared by the trajectories of a multi-start subgradient. They are read without locking. An improvement of UB is written under the mutex
+   together with its owner, the index of the trajectory whose onPath stores the incumbent. */
+struct SharedBounds {
+    std::atomic<double> UB;
+    std::atomic<double> LB;
+    std::atomic<int> owner;
+    std::mutex mutex;
+
+    SharedBounds() : UB(__DBL_MAX__), LB(-__DBL_MAX__), owner(-1) {}
+};
+
+/* Lagrangian relaxation of the Online RSA solved by the subgradient method. The length constraint of each demand
+   (multiplier u[d]) and the non-overlapping constraint of each slice of each link (multiplier v[label][s]) are relaxed,
+   so that each demand is routed independently through a shortest path on its own graph. Subproblems are solved in
+   parallel. At each iteration, the Lagrangian paths are repaired into a feasible joint assignment giving an upper bound.
+   The length multipliers start at the exact optimum of their own dual; with a single demand, this solves the Lagrangian dual and no iteration is run. */
 class Subgradient : public RSA {
-    
-private:
+
+protected:
     const double EPSILON = 0.0001;
-    const int SOURCE;
-    const int TARGET;
-    const int MAX_LENGTH;
+    const int DELTA_STEPPING_MIN_ARCS = 100000;
     const int MAX_NB_IT_WITHOUT_IMPROVEMENT;
     const int MAX_NB_IT;
+    const int NB_THREADS;
+    const Input::MultiplierUpdate MULTIPLIER_UPDATE;
+    const double TARGET_GAP;
 
+    int nbSlices;
     int iteration;
     int itWithoutImprovement;
 
@@ -25,27 +49,106 @@ private:
     bool isFeasible;
     bool isOptimal;
 
-    /* stores the value of the Lagrangian multiplier during each iteration */
-    std::vector<double> lagrangianMultiplier;
+    /* the current step size and the lambda used for computing it */
+    double stepSize;
+    double lambda;
+
+    /* lengthMultiplier[d] is the multiplier of the length constraint of the d-th demand, and bestLengthMultiplier[d] its value when LB was last improved */
+    std::vector<double> lengthMultiplier;
+    std::vector<double> bestLengthMultiplier;
+
+    /* overlapMultiplier[label*nbSlices + s] is the multiplier of the non-overlapping constraint of slice s on link label, and bestOverlapMultiplier its value when LB was last improved */
+    std::vector<double> overlapMultiplier;
+    std::vector<double> bestOverlapMultiplier;
+
+    /* lengthSlack[d] is the slack of the length constraint of the d-th demand (i.e., maxLength - length of its path) */
+    std::vector<double> lengthSlack;
+
+    /* overlapSlack[label*nbSlices + s] is the slack of the non-overlapping constraint (i.e., 1 - number of paths using slice s of link label) */
+    std::vector<double> overlapSlack;
+
+    /* Arcs of graph #d in contiguous arrays indexed by arc id, filled once: vecFlatBaseCost[d][id] is the coefficient of the arc according to the
+       chosen metric, vecFlatLength[d][id] its length, and [vecFlatWindowBegin[d][id], vecFlatWindowEnd[d][id]) the range of overlapPrefix covering its slices */
+    std::vector< std::vector<double> > vecFlatBaseCost;
+    std::vector< std::vector<double> > vecFlatLength;
+    std::vector< std::vector<int> > vecFlatWindowBegin;
+    std::vector< std::vector<int> > vecFlatWindowEnd;
+
+    /* vecFlatCost[d][id] is the cost of the arc on graph #d during the current iteration. cost = c + u[d]*length + sum of v over the slices covered by the arc */
+    std::vector< std::vector<double> > vecFlatCost;
+
+    /* vecFlatTail[d][id] and vecFlatHead[d][id] are the labels of the endpoints of the arc, and minBaseCost[d] the smallest non-negative lower bound
+       on the coefficients of graph #d. They define the A* potential h(label) = u[d]*distance(label, target) + minBaseCost[d]*hops(label, target) */
+    std::vector< std::vector<int> > vecFlatTail;
+    std::vector< std::vector<int> > vecFlatHead;
+    std::vector<double> minBaseCost;
+
+    /* vecFlatReducedCost[d][id] is the cost of the arc reduced by the A* potential: cost - h(tail) + h(head), which is non-negative */
+    std::vector< std::vector<double> > vecFlatReducedCost;
+
+    /* vecDeltaStepping[d] searches graph #d with parallel delta-stepping when it has at least DELTA_STEPPING_MIN_ARCS arcs and more threads are
+       available than demands; it is NULL when LEMON's Dijkstra is used */
+    std::vector< std::unique_ptr<DeltaStepping> > vecDeltaStepping;
+
+    /* overlapPrefix[label*(nbSlices+1) + s] is the sum of the overlap multipliers of the slices before s on link label */
+    std::vector<double> overlapPrefix;
+
+    /* the virtual source and target nodes of each graph */
+    std::vector<ListDigraph::Node> vecSource;
+    std::vector<ListDigraph::Node> vecTarget;
+
+    /* vecPath[d] stores the arcs of the shortest path of graph #d found in the current iteration, and pathDist[d] its Lagrangian cost */
+    std::vector< std::vector<ListDigraph::Arc> > vecPath;
+    std::vector<double> pathDist;
+
+    /* deflected subgradient: the direction used in the previous iteration */
+    std::vector<double> direction;
 
-    /* stores the value of the slack of length constraint (i.e., b - Dx) during each iteration */
-    std::vector<double> slack;
+    /* volume algorithm and bundle method: the stability center (multipliers with the best accepted lagrangian value) and its value. Empty before the first update */
+    std::vector<double> center;
+    double centerValue;
 
-    /* stores the value of the step size used for updating the Lagrangian Multiplier during each iteration */
-    std::vector<double> stepSize;
+    /* bundle method: the subgradients of the cuts, and their linearization errors at the center */
+    std::vector< std::vector<double> > bundle;
+    std::vector<double> bundleError;
 
-    /* stores the value of lambda used for updating the step size for each iteration */
-    std::vector<double> lambda;
+    /* volume algorithm: running average of the subgradients. bundle method: subgradient of the aggregated cut, whose linearization error at the center is aggregateError */
+    std::vector<double> aggregate;
+    double aggregateError;
 
-    /* refers to the cost of an arc during iteration k of subgradient. cost = c_{ij} + u_k*length_{ij} */
-    ListDigraph::ArcMap<double> cost;  
-             
+    /* bundle method: the proximal parameter and the increase of the lagrangian value predicted by the model at the last candidate */
+    double proximalParameter;
+    double predictedIncrease;
+
+    /* volume algorithm: (*vecPrimal[d])[a] is the weight of arc a in the running average of the paths of graph #d, i.e., a primal estimate */
+    std::vector< std::shared_ptr<ArcCost> > vecPrimal;
+
+    /* statistics: number of shortest path computations, and iteration, time and number of shortest paths when the gap first reached TARGET_GAP (-1 if not yet) */
+    int nbShortestPaths;
+    int itToGap;
+    double timeToGap;
+    int nbShortestPathsToGap;
+    std::chrono::high_resolution_clock::time_point startTime;
+
+    /* isReserved[label][s] is true if slice s of link label is taken by a demand already repaired in the current iteration */
+    std::vector< std::vector<bool> > isReserved;
+
+    /* multi-start: the bounds shared with the other trajectories (NULL in a single run), and the index of this trajectory */
+    SharedBounds *shared;
+    int startId;
+
+    /* the multipliers reached in previous optimizations, used for warm-starting this one (NULL if none) */
+    MultiplierCache *cache;
 
 public:
 	/************************************************/
 	/*				    Constructors 		   		*/
 	/************************************************/
-    Subgradient(const Instance &inst);
+    Subgradient(const Instance &inst, MultiplierCache *multiplierCache = NULL);
+
+    /* Builds trajectory #start of a multi-start run without running it: its subproblems are solved sequentially and its starting lambda and
+       overlap multipliers depend on start. */
+    Subgradient(const Instance &inst, SharedBounds *sharedBounds, int start);
 
 	/************************************************/
 	/*					   Getters 		    		*/
@@ -60,21 +163,22 @@ public:
     bool getIsFeasible() const { return isFeasible; }
     bool getIsOptimal() const { return isOptimal; }
 
-    std::vector<double> getMultiplier() const { return lagrangianMultiplier; }
-    std::vector<double> getStepSize() const { return stepSize; }
-    std::vector<double> getSlack() const { return slack; }
-    std::vector<double> getLambda() const { return lambda; }
-
-    double getMultiplier_k(int k) const { return lagrangianMultiplier[k]; }
-    double getStepSize_k(int k) const { return stepSize[k]; }
-    double getSlack_k(int k) const { return slack[k]; }
-    double getLambda_k(int k) const { return lambda[k]; }
-
-    double getLastMultiplier() const { return lagrangianMultiplier[lagrangianMultiplier.size() - 1]; }
-    double getLastStepSize() const { return stepSize[stepSize.size() - 1]; }
-    double getLastSlack() const { return slack[slack.size() - 1]; }
-    double getLastLambda() const { return lambda[lambda.size() - 1]; }
-    
+    double getStepSize() const { return stepSize; }
+    double getLambda() const { return lambda; }
+
+    std::vector<double> getLengthMultiplier() const { return lengthMultiplier; }
+    std::vector<double> getOverlapMultiplier() const { return overlapMultiplier; }
+    double getLengthMultiplier_d(int d) const { return lengthMultiplier[d]; }
+    double getOverlapMultiplier_e_s(int label, int s) const { return overlapMultiplier[label*nbSlices + s]; }
+
+    int getNbShortestPaths() const { return nbShortestPaths; }
+    int getItToGap() const { return itToGap; }
+    double getTimeToGap() const { return timeToGap; }
+    double getPrimalEstimate(int d, const ListDigraph::Arc &a) const { return (*vecPrimal[d])[a]; }
+
+    /* Trajectories of a multi-start run do not display anything while running in parallel. */
+    bool isVerbose() const { return shared == NULL; }
+
 	/************************************************/
 	/*					   Setters 		    		*/
 	/************************************************/
@@ -90,10 +194,8 @@ public:
     void setIsFeasible(bool i) { isFeasible = i;}
     void setIsOptimal(bool i) { isOptimal = i; }
 
-    void setMultiplier_k (int k, double i) { lagrangianMultiplier[k] = i; }
-    void setStepSize_k(int k, double i){ stepSize[k] = i; }
-    void setSlack_k(int k, double i){ slack[k] = i; }
-    void setLambda_k(int k, double i){ lambda[k] = i; }
+    void setStepSize(double i){ stepSize = i; }
+    void setLambda(double i){ lambda = i; }
 
 	/************************************************/
 	/*					   Methods 		    		*/
@@ -104,57 +206,168 @@ public:
     /* Call preprocessing functions. */
     void subgradientPreprocessing();
 
-    /* Updates the arc costs according to the last lagrangian multiplier available. cost = c + u_k*length */
-    void updateCosts();
+    /* Fills the flat arc arrays of graph #d. */
+    void buildArcArrays(int d);
+
+    /* Updates the prefix sums of the overlap multipliers of each link. */
+    void updateOverlapPrefix();
+
+    /* Updates the arc costs of graph #d according to the current multipliers. cost = c + u[d]*length + sum of v over the slices covered by the arc */
+    void updateCosts(int d);
+
+    /* Updates the arc costs of graph #d reduced by the A* potential. Since every cost is at least u[d]*length + minBaseCost[d], the potential is a
+       lower bound on the cost of reaching the target that never decreases by more than the cost of an arc: Dijkstra on the reduced costs is A*. */
+    void updateReducedCosts(int d);
+
+    /* Solves the Lagrangian relaxation of the RSA using the Subgradient Method. */
+    void run();
+
+    /* Solves the Lagrangian dual of the length constraint of the d-th demand exactly, ignoring the non-overlapping constraints. The dual is a concave
+       piecewise-linear function of u whose pieces are the (cost, length) extreme points of the paths: they are found by a hull search, each
+       step running one shortest path at the multiplier where the two current points have the same Lagrangian cost. Sets lengthMultiplier[d]
+       to the optimal multiplier, stores in best the cheapest path found within the length limit and returns the dual value. */
+    double solveLengthDual(int d, std::vector<ListDigraph::Arc> &best);
+
+    /* Seeds the overlap multipliers and lambda with the values cached for similar demands, if any. The overlap multipliers are the largest cached ones.
+       The length multipliers are kept: solveLengthDual has just set them to their exact optimum for the current network state. */
+    void warmStart();
+
+    /* Stores in the cache the overlap multipliers giving the best LB and the last lambda. Only batches of several demands are stored. */
+    void storeMultipliers();
+
+    /* Stores in path the shortest path of graph #d with arc weights costWeight*c + lengthWeight*length. */
+    void searchParametricPath(int d, double costWeight, double lengthWeight, std::vector<ListDigraph::Arc> &path);
 
-    /* Solves the Constrained Shortest Path from node s to node t using the Subgradient Method. */
-    void run(const ListDigraph::Node &s, const ListDigraph::Node &t);
+    /* Solves the shortest path subproblem of every demand, using several threads. Returns false if some demand cannot reach its target. */
+    bool solveSubproblems();
+
+    /* Solves the shortest path subproblem of every demand with index in [first, ..., last) by steps of step. */
+    void solveSubproblems(int first, int last, int step);
+
+    /* Returns the value of the Lagrangian function for the paths found in the current iteration. */
+    double getLagrangianValue();
 
     /* Updates the known lower bound. */
     void updateLB(double bound);
 
     /* Updates the known upper bound. */
     void updateUB(double bound);
-    
-    /* Updates lagrangian multiplier with the rule: u[k+1] = u[k] + t[k]*violation */
+
+    /* Takes the best upper bound found by the other trajectories of a multi-start run. */
+    void synchronizeBounds();
+
+    /* Returns the length multipliers followed by the overlap multipliers. */
+    std::vector<double> getMultipliers() const;
+
+    /* Sets the length multipliers followed by the overlap multipliers, projecting them on the non-negative orthant. */
+    void setMultipliers(const std::vector<double> &multipliers);
+
+    /* Returns the subgradient (i.e., the violation of each relaxed constraint) for the paths found in the current iteration, ordered as in getMultipliers. */
+    std::vector<double> getSubgradient() const;
+
+    /* Updates lagrangian multipliers according to the rule chosen in Input. */
     void updateMultiplier();
 
-    /* Updates the step size with the rule: lambda*(UB - Z[u])/|slack| */
+    /* Updates lagrangian multipliers with the rule: u[k+1] = max(0, u[k] + t[k]*violation) */
+    void updateSubgradientMultiplier();
+
+    /* Updates lagrangian multipliers along the direction d[k] = g[k] + beta*d[k-1], where beta = max(0, -1.5*g[k].d[k-1]/|d[k-1]|^2) removes the zig-zagging between two iterations. */
+    void updateDeflectedMultiplier();
+
+    /* Updates lagrangian multipliers with the volume algorithm: the center moves to the current multipliers if they improve its value, and the next
+       multipliers are taken from the center along the running average of the subgradients. The primal estimates are averaged in the same way. */
+    void updateVolumeMultiplier();
+
+    /* Updates lagrangian multipliers with a proximal bundle method keeping a few cuts, which are replaced by their aggregation when the bundle is
+       full. The center moves (serious step) if the lagrangian value achieves a fraction of the increase predicted by the model. */
+    void updateBundleMultiplier();
+
+    /* Returns the weights of the cuts solving the dual of the proximal problem: min t/2*|sum of w[k]*g[k]|^2 + sum of w[k]*e[k] over the simplex. */
+    std::vector<double> solveProximalProblem();
+
+    /* Updates the primal estimates: x = alpha*x[k] + (1 - alpha)*x, where x[k] are the paths found in the current iteration. */
+    void updatePrimalEstimate(double alpha);
+
+    /* Returns the step lambda*(UB - value)/norm, estimating UB from value while no feasible solution is known. */
+    double getPolyakStep(double value, double norm);
+
+    /* Updates the step size with the rule: lambda*(UB - Z[u])/|g|^2 */
     void updateStepSize();
-    
+
     /* Updates the lambda used in the update of step size. Lambda is halved if LB has failed to increade in some fixed number of iterations */
     void updateLambda();
-    
-    /* Updates the slack of length constraint for a given path length */
-    void updateSlack(double pathLength);
-    
+
+    /* Updates the slack of the relaxed constraints for the paths found in the current iteration */
+    void updateSlack();
+
+    /* Returns the squared norm of the subgradient, ignoring the components that cannot move a null multiplier. */
+    double getSubgradientNorm();
+
+    /* Returns the relative gap between the bounds, or __DBL_MAX__ while no feasible solution is known. */
+    double getGap();
+
+    /* Records the iteration, time and number of shortest paths at which the gap first reaches TARGET_GAP. */
+    void updateStatistics();
+
     /* Verifies if optimality condition has been achieved and update STOP flag. */
     void updateStop(bool &STOP);
 
-    /* Tests if CSP is feasible by searching for a shortest path with arc costs based on their physical length. */
-    bool testFeasibility(const ListDigraph::Node &s, const ListDigraph::Node &t);
-    
-    /* Assigns length as the main cost of the arcs. */
-    void setLengthCost();
-    
-    /* Stores the path found in the arcMap onPath. */
-    void updateOnPath(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t);
-    
-    /* Returns the physical length of the path. */
-    double getPathLength(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t);
-    
-    /* Returns the actual cost of the path according to the metric used. */
-    double getPathCost(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t);
-    
+    /* Tests if the d-th demand can be routed within its length limit, using the memoized slice-layer distances from its source. */
+    bool testFeasibility(int d);
+
+    /* Builds a feasible joint assignment from the Lagrangian paths and updates the upper bound and onPath if it is improved. Returns true if it succeeds. */
+    bool repair();
+
+    /* Searches for a path of graph #d that respects the length limit and only uses free slice windows: the shortest path with Lagrangian costs
+       if it is short enough, otherwise the cheapest splice of one of its prefixes with a shortest-length suffix. Returns false if none is found. */
+    bool repairPath(int d, std::vector<ListDigraph::Arc> &path);
+
+    /* Stores in path the cheapest path of graph #d made of a prefix of longPath followed by the shortest-length path to the target over free
+       slice windows, within the length limit. The empty prefix gives the shortest-length path. Returns false if none is found. */
+    bool splicePath(int d, const std::vector<ListDigraph::Arc> &longPath, std::vector<ListDigraph::Arc> &path);
+
+    /* Computes the distance from each node of graph #d to the target with arc weights indexed by arc id, and the arc id following each node on the
+       shortest path (-1 if none). If onlyFreeWindows is true, the arcs whose slice window is reserved are ignored. */
+    void computeDistancesToTarget(int d, const std::vector<double> &weight, bool onlyFreeWindows, std::vector<double> &dist, std::vector<int> &nextArc);
+
+    /* Returns, for each demand, the keys of the arcs that cannot belong to a solution cheaper than UB: the Lagrangian bound at the multipliers
+       giving the best LB, with the path of the demand forced through the arc, exceeds UB. Every solution of cost at most UB is kept. */
+    std::vector< std::set<ArcKey> > getFixedArcs();
+
+    /* Returns true if the slice window covered by arc a of graph #d is free (i.e., not reserved by a repaired demand). */
+    bool isWindowFree(int d, const ListDigraph::Arc &a);
+
+    /* Returns true if every arc of the path of graph #d has a free slice window. */
+    bool isPathFree(int d, const std::vector<ListDigraph::Arc> &path);
+
+    /* Reserves the slice windows covered by the path of graph #d. */
+    void reservePath(int d, const std::vector<ListDigraph::Arc> &path);
+
+    /* Stores the path found by a Dijkstra run on graph #d. */
+    void storePath(Dijkstra< ListDigraph, FlatArcCost > &shortestPath, int d, std::vector<ListDigraph::Arc> &path);
+
+    /* Stores the path found by a delta-stepping run on graph #d. */
+    void storePath(const DeltaStepping &shortestPath, int d, std::vector<ListDigraph::Arc> &path);
+
+    /* Builds the delta-stepping search of the graphs large enough, sharing the threads left by the parallel subproblems. */
+    void buildDeltaStepping();
+
+    /* Stores the paths of every demand in the arcMap onPath. */
+    void updateOnPath(const std::vector< std::vector<ListDigraph::Arc> > &paths);
+
+    /* Returns the physical length of a path of graph #d. */
+    double getPathLength(int d, const std::vector<ListDigraph::Arc> &path);
+
+    /* Returns the actual cost of a path of graph #d according to the metric used. */
+    double getPathCost(int d, const std::vector<ListDigraph::Arc> &path);
+
     /************************************************/
 	/*					   Display 		    		*/
 	/************************************************/
-    std::string getPathString(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t);
-    void displayPath(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t);
-    void displayMainParameters(Dijkstra< ListDigraph, ListDigraph::ArcMap<double> > &path, const ListDigraph::Node &s, const ListDigraph::Node &t);
-    void displayStepSize();
+    std::string getPathString(int d, const std::vector<ListDigraph::Arc> &path);
+    void displayMainParameters();
     void displayMultiplier();
     void displaySlack();
-    void displayLambda();
-};    
-#endif
\ No newline at end of file
+    void displayStatistics();
+};
+#endif